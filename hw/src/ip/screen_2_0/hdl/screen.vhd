@@ -5,19 +5,30 @@ use ieee.numeric_std.all;
 entity screen is
 	generic (
 		-- Users to add parameters here
-
+		-- Entries (up to 4 bytes each) of the TX queue in front of the screen_controller
+		FIFO_DEPTH : integer := 16;
+		-- SCK divider after reset (SCK = 125 MHz / (2 * SPI_CLK_DIV)), the driver can change it
+		SPI_CLK_DIV : integer := 10;
 		-- User parameters ends
 		-- Do not modify the parameters beyond this line
 
 		-- Parameters of Axi Slave Bus Interface S00_AXI
 		C_S00_AXI_DATA_WIDTH : integer := 32;
-		C_S00_AXI_ADDR_WIDTH : integer := 4
+		C_S00_AXI_ADDR_WIDTH : integer := 6
 	);
 	port (
 		-- Users to add ports here --
 		-- Physical pins
 		LED : out std_logic_vector(1 downto 0);
 		PMOD: out std_logic_vector(7 downto 0);
+		-- Ports of Axi Stream Slave S00_AXIS, clocked by s00_axi_aclk (e.g. AXI DMA MM2S)
+		s00_axis_tdata	: in  std_logic_vector(31 downto 0) := (others => '0');
+		s00_axis_tkeep	: in  std_logic_vector(3 downto 0) := (others => '1');
+		s00_axis_tlast	: in  std_logic := '0';
+		s00_axis_tvalid	: in  std_logic := '0';
+		s00_axis_tready	: out std_logic;
+		-- Interrupt, level high, on the end of power transitions and when the TX queue runs idle
+		irq : out std_logic;
 		-- User ports ends --
 		-- Do not modify the ports beyond this line
 
@@ -51,22 +62,36 @@ architecture arch_imp of screen is
 	-- component declaration
 	component screen_slave_lite_v2_0_S00_AXI is
 		generic (
+			FIFO_DEPTH         : integer := 16;
+			SPI_CLK_DIV        : integer := 10;
 			C_S_AXI_DATA_WIDTH : integer := 32;
-			C_S_AXI_ADDR_WIDTH : integer := 4
+			C_S_AXI_ADDR_WIDTH : integer := 6
 		);
 		port (
 			-- User ports --
 			-- Control
 			ON_OFF      : out std_logic;
-			SPI_TRIGGER : out std_logic;
 			-- Status
 			ON_OFF_STATUS : in std_logic_vector(1 downto 0);
 			SPI_READY     : in std_logic;
 			--SPI data request
 			SPI_DATA_REQUEST : in std_logic;
-			-- Data input
-			BYTE      : out std_logic_vector(7 downto 0);
-			DC_SELECT : out std_logic;
+			-- TX queue push
+			TX_PUSH  : out std_logic;
+			TX_DATA  : out std_logic_vector(31 downto 0);
+			TX_DC    : out std_logic_vector(3 downto 0);
+			TX_COUNT : out std_logic_vector(1 downto 0);
+			-- TX queue status
+			FIFO_LEVEL : in std_logic_vector(15 downto 0);
+			FIFO_EMPTY : in std_logic;
+			FIFO_FULL  : in std_logic;
+			FIFO_OVERFLOW : in std_logic;
+			-- SCK divider
+			SPI_CLK_DIV_SEL : out std_logic_vector(7 downto 0);
+			-- Interrupt
+			IRQ_ENABLE : out std_logic_vector(1 downto 0);
+			IRQ_ACK    : out std_logic_vector(1 downto 0);
+			IRQ_STATUS : in  std_logic_vector(1 downto 0);
 			-- User ports end --
 			S_AXI_ACLK    : in  std_logic;
 			S_AXI_ARESETN : in  std_logic;
@@ -94,6 +119,9 @@ architecture arch_imp of screen is
 
 	-- User component
 	component screen_controller is
+		Generic (
+			SPI_CLK_DIV : positive := 10
+		);
 		Port (
 			-- Sync
 			CLK    : in std_logic;
@@ -114,6 +142,9 @@ architecture arch_imp of screen is
 			BYTE      : in  std_logic_vector(7 downto 0);
 			DC_SELECT : in  std_logic;
 	
+			-- SCK divider
+			SPI_CLK_DIV_SEL : in std_logic_vector(7 downto 0);
+	
 			-- Pmod physical pins
 			MOSI         : out std_logic;
 			SCK          : out std_logic;
@@ -125,6 +156,80 @@ architecture arch_imp of screen is
 		);
 	end component;
 
+	component screen_stream_sink is
+		Port (
+			-- AXI-Stream slave, same clock as the queue
+			S_AXIS_TDATA  : in  std_logic_vector(31 downto 0);
+			S_AXIS_TKEEP  : in  std_logic_vector(3 downto 0);
+			S_AXIS_TLAST  : in  std_logic;
+			S_AXIS_TVALID : in  std_logic;
+			S_AXIS_TREADY : out std_logic;
+
+			-- Pushes of the AXI slave
+			TX_PUSH  : in std_logic;
+			TX_DATA  : in std_logic_vector(31 downto 0);
+			TX_DC    : in std_logic_vector(3 downto 0);
+			TX_COUNT : in std_logic_vector(1 downto 0);
+
+			-- TX queue push interface
+			FIFO_FULL  : in  std_logic;
+			PUSH       : out std_logic;
+			PUSH_DATA  : out std_logic_vector(31 downto 0);
+			PUSH_DC    : out std_logic_vector(3 downto 0);
+			PUSH_COUNT : out std_logic_vector(1 downto 0)
+		);
+	end component;
+
+	component screen_tx_queue is
+		Generic (
+			FIFO_DEPTH : positive := 16
+		);
+		Port (
+			-- Sync
+			CLK    : in std_logic;
+			RESETN : in std_logic;
+
+			-- Push interface (AXI slave)
+			PUSH       : in std_logic;
+			PUSH_DATA  : in std_logic_vector(31 downto 0);
+			PUSH_DC    : in std_logic_vector(3 downto 0);
+			PUSH_COUNT : in std_logic_vector(1 downto 0);
+
+			-- Queue status
+			FIFO_LEVEL : out std_logic_vector(15 downto 0);
+			FIFO_EMPTY : out std_logic;
+			FIFO_FULL  : out std_logic;
+			FIFO_OVERFLOW : out std_logic;
+			TX_IDLE    : out std_logic;
+
+			-- screen_controller interface
+			SPI_READY   : in  std_logic;
+			SPI_TRIGGER : out std_logic;
+			BYTE        : out std_logic_vector(7 downto 0);
+			DC_SELECT   : out std_logic
+		);
+	end component;
+
+	component screen_irq is
+		Port (
+			-- Sync
+			CLK    : in std_logic;
+			RESETN : in std_logic;
+
+			-- Events
+			ON_OFF_STATUS : in std_logic_vector(1 downto 0);
+			TX_IDLE       : in std_logic;
+
+			-- IRQ_ENABLE and IRQ_STATUS of the AXI slave, IRQ_ACK is high for one cycle per write
+			IRQ_ENABLE : in  std_logic_vector(1 downto 0);
+			IRQ_ACK    : in  std_logic_vector(1 downto 0);
+			IRQ_STATUS : out std_logic_vector(1 downto 0);
+
+			-- Interrupt, level high
+			IRQ : out std_logic
+		);
+	end component;
+
 	-- User signals
 	signal on_off           : std_logic;
 	signal spi_trigger      : std_logic;
@@ -133,12 +238,31 @@ architecture arch_imp of screen is
 	signal spi_data_request : std_logic;
 	signal byte             : std_logic_vector(7 downto 0);
 	signal dc_select        : std_logic;
+	signal tx_push          : std_logic;
+	signal tx_data          : std_logic_vector(31 downto 0);
+	signal tx_dc            : std_logic_vector(3 downto 0);
+	signal tx_count         : std_logic_vector(1 downto 0);
+	signal push             : std_logic;
+	signal push_data        : std_logic_vector(31 downto 0);
+	signal push_dc          : std_logic_vector(3 downto 0);
+	signal push_count       : std_logic_vector(1 downto 0);
+	signal fifo_level       : std_logic_vector(15 downto 0);
+	signal fifo_empty       : std_logic;
+	signal fifo_full        : std_logic;
+	signal fifo_overflow    : std_logic;
+	signal tx_idle          : std_logic;
+	signal spi_clk_div_sel  : std_logic_vector(7 downto 0);
+	signal irq_enable       : std_logic_vector(1 downto 0);
+	signal irq_ack          : std_logic_vector(1 downto 0);
+	signal irq_status       : std_logic_vector(1 downto 0);
 
 begin
 
 	-- Instantiation of Axi Bus Interface S00_AXI
 	screen_slave_lite_v2_0_S00_AXI_inst : screen_slave_lite_v2_0_S00_AXI
 		generic map (
+			FIFO_DEPTH         => FIFO_DEPTH,
+			SPI_CLK_DIV        => SPI_CLK_DIV,
 			C_S_AXI_DATA_WIDTH => C_S00_AXI_DATA_WIDTH,
 			C_S_AXI_ADDR_WIDTH => C_S00_AXI_ADDR_WIDTH
 		)
@@ -146,15 +270,27 @@ begin
 			-- User ports --
 			-- Control
 			ON_OFF      => on_off,
-			SPI_TRIGGER => spi_trigger,
 			-- Status
 			ON_OFF_STATUS => on_off_status,
-			SPI_READY     => spi_ready,
+			SPI_READY     => tx_idle,
 			--SPI data request
 			SPI_DATA_REQUEST => spi_data_request,
-			-- Data input
-			BYTE      => byte,
-			DC_SELECT => dc_select,
+			-- TX queue push
+			TX_PUSH  => tx_push,
+			TX_DATA  => tx_data,
+			TX_DC    => tx_dc,
+			TX_COUNT => tx_count,
+			-- TX queue status
+			FIFO_LEVEL => fifo_level,
+			FIFO_EMPTY => fifo_empty,
+			FIFO_FULL  => fifo_full,
+			FIFO_OVERFLOW => fifo_overflow,
+			-- SCK divider
+			SPI_CLK_DIV_SEL => spi_clk_div_sel,
+			-- Interrupt
+			IRQ_ENABLE => irq_enable,
+			IRQ_ACK    => irq_ack,
+			IRQ_STATUS => irq_status,
 			-- User ports end --
 			S_AXI_ACLK    => s00_axi_aclk,
 			S_AXI_ARESETN => s00_axi_aresetn,
@@ -180,7 +316,62 @@ begin
 		);
 
 	-- Add user logic here
+	screen_stream_sink_inst: screen_stream_sink
+		port map (
+		-- AXI-Stream slave, same clock as the queue
+		S_AXIS_TDATA  => s00_axis_tdata,
+		S_AXIS_TKEEP  => s00_axis_tkeep,
+		S_AXIS_TLAST  => s00_axis_tlast,
+		S_AXIS_TVALID => s00_axis_tvalid,
+		S_AXIS_TREADY => s00_axis_tready,
+
+		-- Pushes of the AXI slave
+		TX_PUSH  => tx_push,
+		TX_DATA  => tx_data,
+		TX_DC    => tx_dc,
+		TX_COUNT => tx_count,
+
+		-- TX queue push interface
+		FIFO_FULL  => fifo_full,
+		PUSH       => push,
+		PUSH_DATA  => push_data,
+		PUSH_DC    => push_dc,
+		PUSH_COUNT => push_count
+		);
+
+	screen_tx_queue_inst: screen_tx_queue
+		generic map (
+		FIFO_DEPTH => FIFO_DEPTH
+		)
+		port map (
+		-- Sync
+		CLK    => s00_axi_aclk,
+		RESETN => s00_axi_aresetn,
+
+		-- Push interface (AXI slave)
+		PUSH       => push,
+		PUSH_DATA  => push_data,
+		PUSH_DC    => push_dc,
+		PUSH_COUNT => push_count,
+
+		-- Queue status
+		FIFO_LEVEL => fifo_level,
+		FIFO_EMPTY => fifo_empty,
+		FIFO_FULL  => fifo_full,
+		FIFO_OVERFLOW => fifo_overflow,
+		TX_IDLE    => tx_idle,
+
+		-- screen_controller interface
+		SPI_READY   => spi_ready,
+		SPI_TRIGGER => spi_trigger,
+		BYTE        => byte,
+		DC_SELECT   => dc_select
+		);
+
 	screen_controller_inst: screen_controller
+		generic map (
+		SPI_CLK_DIV => SPI_CLK_DIV
+		)
 		port map (
 		-- Sync
 		CLK    => s00_axi_aclk,
@@ -201,6 +392,9 @@ begin
 		BYTE      => byte,
 		DC_SELECT => dc_select,
 
+		-- SCK divider
+		SPI_CLK_DIV_SEL => spi_clk_div_sel,
+
 		-- Pmod physical pins
 		MOSI         => PMOD(1),
 		SCK          => PMOD(3),
@@ -211,6 +405,25 @@ begin
 		PMOD_ENABLE  => PMOD(7)
 		);
 
+	screen_irq_inst: screen_irq
+		port map (
+		-- Sync
+		CLK    => s00_axi_aclk,
+		RESETN => s00_axi_aresetn,
+
+		-- Events
+		ON_OFF_STATUS => on_off_status,
+		TX_IDLE       => tx_idle,
+
+		-- IRQ_ENABLE and IRQ_STATUS of the AXI slave, IRQ_ACK is high for one cycle per write
+		IRQ_ENABLE => irq_enable,
+		IRQ_ACK    => irq_ack,
+		IRQ_STATUS => irq_status,
+
+		-- Interrupt, level high
+		IRQ => irq
+		);
+
 	LED <= on_off_status;
 	PMOD(2) <= '0';
 	-- User logic ends
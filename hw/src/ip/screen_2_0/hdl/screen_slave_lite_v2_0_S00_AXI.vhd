@@ -5,28 +5,43 @@ use ieee.numeric_std.all;
 entity screen_slave_lite_v2_0_S00_AXI is
 	generic (
 		-- Users to add parameters here
-
+		-- Entries of the TX queue, read back in IP_INFO
+		FIFO_DEPTH : integer := 16;
+		-- SCK divider of the screen_controller when SPI_CLK_DIV holds 0, read back in bits 15:8
+		SPI_CLK_DIV : integer := 10;
 		-- User parameters ends
 		-- Do not modify the parameters beyond this line
 
 		-- Width of S_AXI data bus
 		C_S_AXI_DATA_WIDTH : integer := 32;
 		-- Width of S_AXI address bus
-		C_S_AXI_ADDR_WIDTH : integer := 4
+		C_S_AXI_ADDR_WIDTH : integer := 6
 	);
 	port (
 		-- Users to add ports here --
 		-- Control
 		ON_OFF      : out std_logic;
-		SPI_TRIGGER : out std_logic;
 		-- Status
 		ON_OFF_STATUS : in std_logic_vector(1 downto 0);
 		SPI_READY     : in std_logic;
 		--SPI data request
 		SPI_DATA_REQUEST : in std_logic;
-		-- Data input
-		BYTE      : out std_logic_vector(7 downto 0);
-		DC_SELECT : out std_logic;
+		-- TX queue push, one entry per SPI_CTRL trigger or SPI_BURST write
+		TX_PUSH  : out std_logic;
+		TX_DATA  : out std_logic_vector(31 downto 0);
+		TX_DC    : out std_logic_vector(3 downto 0);
+		TX_COUNT : out std_logic_vector(1 downto 0);
+		-- TX queue status
+		FIFO_LEVEL : in std_logic_vector(15 downto 0);
+		FIFO_EMPTY : in std_logic;
+		FIFO_FULL  : in std_logic;
+		FIFO_OVERFLOW : in std_logic; -- A push was dropped, held in slv_reg3(4) until cleared
+		-- SCK divider, 0 keeps the SPI_CLK_DIV generic
+		SPI_CLK_DIV_SEL : out std_logic_vector(7 downto 0);
+		-- Interrupt sources, IRQ_ACK is high for one cycle per IRQ_STATUS write
+		IRQ_ENABLE : out std_logic_vector(1 downto 0);
+		IRQ_ACK    : out std_logic_vector(1 downto 0);
+		IRQ_STATUS : in  std_logic_vector(1 downto 0);
 		-- User ports ends --
 
 		-- Do not modify the ports beyond this line
@@ -113,17 +128,32 @@ architecture arch_imp of screen_slave_lite_v2_0_S00_AXI is
 	-- ADDR_LSB = 2 for 32 bits (n downto 2)
 	-- ADDR_LSB = 3 for 64 bits (n downto 3)
 	constant ADDR_LSB  : integer := (C_S_AXI_DATA_WIDTH/32)+ 1;
-	constant OPT_MEM_ADDR_BITS : integer := 1;
+	constant OPT_MEM_ADDR_BITS : integer := 3;
 	------------------------------------------------
 	---- Signals for user logic register space example
 	--------------------------------------------------
-	---- Number of Slave Registers 4
+	---- Number of Slave Registers 16 (10 used)
 	signal slv_reg0	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 	signal slv_reg1	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 	signal slv_reg2	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 	signal slv_reg3	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg4	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg5	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg6	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg7	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg10	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+	signal slv_reg11	:std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
 	signal byte_index	: integer;
 
+	-- TX queue push, registered for one cycle after the write
+	signal tx_push_reg  : std_logic;
+	signal tx_data_reg  : std_logic_vector(31 downto 0);
+	signal tx_dc_reg    : std_logic_vector(3 downto 0);
+	signal tx_count_reg : std_logic_vector(1 downto 0);
+
+	-- Acknowledge of the interrupt sources, registered for one cycle after the write
+	signal irq_ack_reg : std_logic_vector(1 downto 0);
+
 	 signal mem_logic  : std_logic_vector(ADDR_LSB + OPT_MEM_ADDR_BITS downto ADDR_LSB);
 
 	 --State machine local parameters
@@ -224,19 +254,47 @@ begin
 	      slv_reg1 <= (others => '0');
 	      slv_reg2 <= (others => '0');
 	      slv_reg3 <= (others => '0');
+	      slv_reg4 <= (others => '0');
+	      slv_reg5 <= (others => '0');
+	      slv_reg6 <= (others => '0');
+	      slv_reg7 <= (others => '0');
+	      slv_reg10 <= (others => '0');
+	      slv_reg11 <= (others => '0');
+	      tx_push_reg  <= '0';
+	      tx_data_reg  <= (others => '0');
+	      tx_dc_reg    <= (others => '0');
+	      tx_count_reg <= (others => '0');
+	      irq_ack_reg <= (others => '0');
 	    else
 			-- User logic registers --
 			-- Put SPI_TRIGGER to '0' by default, so if it is raised by the PS, it will only last
-			-- 1 cycle up to '1'. The screen_controller will detect the rising_edge.
+			-- 1 cycle up to '1'. The byte is pushed to the TX queue by the write itself.
 			slv_reg2(9) <= '0'; 
-			-- Capture ON_OFF_STATUS, SPI_DATA_REQUEST and SPI_READY
+			tx_push_reg <= '0';
+			irq_ack_reg <= (others => '0');
+			-- Capture ON_OFF_STATUS, SPI_DATA_REQUEST, SPI_READY and the TX queue status
 			slv_reg1(1 downto 0) <= ON_OFF_STATUS; 
-			slv_reg3(1 downto 0) <= SPI_DATA_REQUEST & SPI_READY;
+			slv_reg3(3 downto 0) <= FIFO_FULL & FIFO_EMPTY & SPI_DATA_REQUEST & SPI_READY;
+			slv_reg3(31 downto 16) <= FIFO_LEVEL;
+			if (FIFO_OVERFLOW = '1') then
+			  slv_reg3(4) <= '1';
+			end if;
+			-- Read only TX queue depth and features
+			slv_reg6(15 downto 0)  <= std_logic_vector(to_unsigned(FIFO_DEPTH, 16));
+			slv_reg6(16)           <= '0'; -- Reserved
+			slv_reg6(17)           <= '1'; -- S00_AXIS stream port
+			slv_reg6(18)           <= '1'; -- IRQ_ENABLE and IRQ_STATUS
+			slv_reg6(31 downto 19) <= (others => '0');
+			-- Pending interrupt sources
+			slv_reg11(31 downto 2) <= (others => '0');
+			slv_reg11(1 downto 0)  <= IRQ_STATUS;
+			-- Read only SCK divider after reset
+			slv_reg7(15 downto 8) <= std_logic_vector(to_unsigned(SPI_CLK_DIV, 8));
 			-- User logic registers end --
 
 	      if (S_AXI_WVALID = '1') then
 	          case (mem_logic) is
-	          when b"00" =>
+	          when b"0000" =>
 	            for byte_index in 0 to (C_S_AXI_DATA_WIDTH/8-1) loop
 	              if ( S_AXI_WSTRB(byte_index) = '1' ) then
 	                -- Respective byte enables are asserted as per write strobes                   
@@ -244,7 +302,7 @@ begin
 	                slv_reg0(byte_index*8+7 downto byte_index*8) <= S_AXI_WDATA(byte_index*8+7 downto byte_index*8);
 	              end if;
 	            end loop;
-	          when b"01" =>
+	          when b"0001" =>
 	            for byte_index in 0 to (C_S_AXI_DATA_WIDTH/8-1) loop
 	              if ( S_AXI_WSTRB(byte_index) = '1' ) then
 	                -- Respective byte enables are asserted as per write strobes                   
@@ -252,7 +310,7 @@ begin
 	                slv_reg1(byte_index*8+7 downto byte_index*8) <= S_AXI_WDATA(byte_index*8+7 downto byte_index*8);
 	              end if;
 	            end loop;
-	          when b"10" =>
+	          when b"0010" =>
 	            for byte_index in 0 to (C_S_AXI_DATA_WIDTH/8-1) loop
 	              if ( S_AXI_WSTRB(byte_index) = '1' ) then
 	                -- Respective byte enables are asserted as per write strobes                   
@@ -260,19 +318,58 @@ begin
 	                slv_reg2(byte_index*8+7 downto byte_index*8) <= S_AXI_WDATA(byte_index*8+7 downto byte_index*8);
 	              end if;
 	            end loop;
-	          when b"11" =>
+	            -- Single byte: pushed from the write data like SPI_BURST, so a SPI_BURST write
+	            -- in the next cycle cannot overwrite it
+	            if ( S_AXI_WSTRB(1 downto 0) = "11" and S_AXI_WDATA(9) = '1' ) then
+	              tx_push_reg  <= '1';
+	              tx_data_reg  <= x"000000" & S_AXI_WDATA(7 downto 0);
+	              tx_dc_reg    <= "000" & S_AXI_WDATA(8);
+	              tx_count_reg <= "00";
+	            end if;
+	          when b"0011" =>
+	            -- Only FIFO_OVERFLOW is writable, 1 to clear, and a drop in the same cycle keeps it set
+	            if ( S_AXI_WSTRB(0) = '1' and S_AXI_WDATA(4) = '1' and FIFO_OVERFLOW = '0' ) then
+	              slv_reg3(4) <= '0';
+	            end if;
+	          when b"0100" =>
+	            -- Burst: the whole word is pushed as one entry, with the count and D/C flags of slv_reg5
+	            slv_reg4 <= S_AXI_WDATA;
+	            tx_push_reg  <= '1';
+	            tx_data_reg  <= S_AXI_WDATA;
+	            tx_dc_reg    <= slv_reg5(7 downto 4);
+	            tx_count_reg <= slv_reg5(1 downto 0);
+	          when b"0101" =>
 	            for byte_index in 0 to (C_S_AXI_DATA_WIDTH/8-1) loop
 	              if ( S_AXI_WSTRB(byte_index) = '1' ) then
 	                -- Respective byte enables are asserted as per write strobes                   
-	                -- slave registor 3
-	                slv_reg3(byte_index*8+7 downto byte_index*8) <= S_AXI_WDATA(byte_index*8+7 downto byte_index*8);
+	                -- slave registor 5
+	                slv_reg5(byte_index*8+7 downto byte_index*8) <= S_AXI_WDATA(byte_index*8+7 downto byte_index*8);
 	              end if;
 	            end loop;
+	          when b"0111" =>
+	            -- Only the divider byte is writable, the driver changes it with the TX queue drained
+	            if ( S_AXI_WSTRB(0) = '1' ) then
+	              slv_reg7(7 downto 0) <= S_AXI_WDATA(7 downto 0);
+	            end if;
+	          when b"1010" =>
+	            -- Only the enable bits of the two sources are writable
+	            if ( S_AXI_WSTRB(0) = '1' ) then
+	              slv_reg10(1 downto 0) <= S_AXI_WDATA(1 downto 0);
+	            end if;
+	          when b"1011" =>
+	            -- Write 1 to clear the pending sources
+	            if ( S_AXI_WSTRB(0) = '1' ) then
+	              irq_ack_reg <= S_AXI_WDATA(1 downto 0);
+	            end if;
 	          when others =>
 	            slv_reg0 <= slv_reg0;
 	            slv_reg1 <= slv_reg1;
 	            slv_reg2 <= slv_reg2;
 	            slv_reg3 <= slv_reg3;
+	            slv_reg4 <= slv_reg4;
+	            slv_reg5 <= slv_reg5;
+	            slv_reg7 <= slv_reg7;
+	            slv_reg10 <= slv_reg10;
 	        end case;
 	      end if;
 	    end if;
@@ -322,17 +419,27 @@ begin
 	       end if;                                                   
 	  end process;                                          
 	-- Implement memory mapped register select and read logic generation
-	 S_AXI_RDATA <= slv_reg0 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "00") else 
-	 slv_reg1 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "01") else 
-	 slv_reg2 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "10") else
-	 slv_reg3 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "11") else
+	 S_AXI_RDATA <= slv_reg0 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0000") else 
+	 slv_reg1 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0001") else 
+	 slv_reg2 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0010") else
+	 slv_reg3 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0011") else
+	 slv_reg4 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0100") else
+	 slv_reg5 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0101") else
+	 slv_reg6 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0110") else
+	 slv_reg7 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "0111") else
+	 slv_reg10 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "1010") else
+	 slv_reg11 when (axi_araddr(ADDR_LSB+OPT_MEM_ADDR_BITS downto ADDR_LSB) = "1011") else
 	 (others => '0');
 
 	-- Add user logic here
-	ON_OFF      <= slv_reg0(0);
-	SPI_TRIGGER <= slv_reg2(9);
-	DC_SELECT   <= slv_reg2(8);
-	BYTE        <= slv_reg2(7 downto 0);
+	ON_OFF   <= slv_reg0(0);
+	TX_PUSH  <= tx_push_reg;
+	TX_DATA  <= tx_data_reg;
+	TX_DC    <= tx_dc_reg;
+	TX_COUNT <= tx_count_reg;
+	SPI_CLK_DIV_SEL <= slv_reg7(7 downto 0);
+	IRQ_ENABLE <= slv_reg10(1 downto 0);
+	IRQ_ACK    <= irq_ack_reg;
 	-- User logic ends
 
 	-- SCREEN IP REGISTER MAP --
@@ -351,15 +458,54 @@ begin
 
 	-- Slave Register 2 (slv_reg2) (WRITE)
 		-- Bits 31:10 : Reserved
-		-- Bit 9      : SPI_TRIGGER (W) Control signal to trigger sending the BYTE to the screen via SPI
+		-- Bit 9      : SPI_TRIGGER (W) Control signal to push the BYTE to the TX queue
 		-- Bit 8      : DC_SELECT (W) Control signal to select Data/Command for the BYTE to send
-			-- 0: Data
-			-- 1: Command
+			-- 0: Command
+			-- 1: Data
 		-- Bits 7:0   : BYTE (W) Byte to send to the screen via SPI
 
-	-- Slave Register 3 (slv_reg3) (READ)
-		-- Bits 31:2  : Reserved
+	-- Slave Register 3 (slv_reg3) (READ/WRITE 1 TO CLEAR)
+		-- Bits 31:16 : FIFO_LEVEL (R) Entries waiting in the TX queue
+		-- Bits 15:5  : Reserved
+		-- Bit 4      : FIFO_OVERFLOW (R/W1C) A SPI_CTRL or SPI_BURST write found the TX queue full and was dropped
+		-- Bit 3      : FIFO_FULL (R) The TX queue is full, further SPI_CTRL and SPI_BURST writes are dropped
+		-- Bit 2      : FIFO_EMPTY (R) The TX queue is empty
 		-- Bit 1      : SPI_DATA_REQUEST (R) Status signal to indicate that the screen_controller is ready to receive a new BYTE to send via SPI
-		-- Bit 0      : SPI_READY (R) Status signal to indicate that the screen_controller has finished sending the previous BYTE via SPI
+		-- Bit 0      : SPI_READY (R) Status signal to indicate that the TX queue is empty and the screen_controller has finished sending the last BYTE via SPI
+
+	-- Slave Register 4 (slv_reg4) (WRITE)
+		-- Bits 31:0  : SPI_BURST (W) Up to 4 bytes pushed to the TX queue as one entry, bits 7:0 are sent first
+
+	-- Slave Register 5 (slv_reg5) (READ/WRITE)
+		-- Bits 31:8  : Reserved
+		-- Bits 7:4   : BURST_DC (RW) DC_SELECT of each byte of SPI_BURST, bit 4 for bits 7:0
+		-- Bits 3:2   : Reserved
+		-- Bits 1:0   : BURST_COUNT (RW) Bytes of SPI_BURST to send minus one
+			-- 00: 1 byte
+			-- 11: 4 bytes
+
+	-- Slave Register 6 (slv_reg6) (READ)
+		-- Bits 31:19 : Reserved
+		-- Bit 18     : IRQ (R) IRQ_ENABLE and IRQ_STATUS are available
+		-- Bit 17     : STREAM (R) S00_AXIS beats are sent as data bytes, byte 0 first
+		-- Bit 16     : Reserved
+		-- Bits 15:0  : FIFO_DEPTH (R) Entries the TX queue can hold
+
+	-- Slave Register 7 (slv_reg7) (READ/WRITE)
+		-- Bits 31:16 : Reserved
+		-- Bits 15:8  : SPI_CLK_DIV_DEFAULT (R) SCK divider used while SPI_CLK_DIV is 0
+		-- Bits 7:0   : SPI_CLK_DIV (RW) SCK divider, SCK = 125 MHz / (2 * SPI_CLK_DIV)
+			-- 0: SPI_CLK_DIV_DEFAULT
+
+	-- Slave Register 10 (slv_reg10) (READ/WRITE)
+		-- Bits 31:2  : Reserved
+		-- Bit 1      : IRQ_TX_IDLE (RW) Raise irq when the TX queue runs idle
+		-- Bit 0      : IRQ_POWER (RW) Raise irq when ON_OFF_STATUS settles in OFF or ON
+
+	-- Slave Register 11 (slv_reg11) (READ/WRITE 1 TO CLEAR)
+		-- Bits 31:2  : Reserved
+		-- Bit 1      : IRQ_TX_IDLE (R/W1C) The TX queue has run idle since the last acknowledge
+		-- Bit 0      : IRQ_POWER (R/W1C) A power transition has ended since the last acknowledge
+		-- irq is high while a pending bit is enabled, pending bits are set whether enabled or not
 
 end arch_imp;
@@ -3,6 +3,9 @@ use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
 
 entity screen_controller is
+    Generic (
+        SPI_CLK_DIV : positive := 10 -- 125MHz clk input // 20 clock divider => 6.25MHz SCK
+    );
     Port (
         -- Sync
         CLK    : in std_logic;
@@ -23,6 +26,9 @@ entity screen_controller is
         BYTE      : in  std_logic_vector(7 downto 0);
         DC_SELECT : in  std_logic;
 
+        -- SCK divider (SCK = CLK / (2 * SPI_CLK_DIV_SEL)), 0 keeps SPI_CLK_DIV
+        SPI_CLK_DIV_SEL : in std_logic_vector(7 downto 0);
+
         -- Pmod physical pins
         MOSI         : out std_logic;
         SCK          : out std_logic;
@@ -479,12 +485,13 @@ begin
             CPOL           => '1', -- Clock idles at high
             CPHA           => '1', -- Data sampled on (second) rising edge and shifted on (first) falling edge
             PREFETCH       => 2,   -- prefetch lookahead cycles
-            SPI_2X_CLK_DIV => 10   -- 125MHz clk input // 20 clock divider => 6.25MHz SCK
+            SPI_2X_CLK_DIV => SPI_CLK_DIV
         )
         Port Map (
-            sclk_i => CLK,
-            pclk_i => CLK,
-            rst_i  => rst,
+            sclk_i    => CLK,
+            pclk_i    => CLK,
+            rst_i     => rst,
+            clk_div_i => SPI_CLK_DIV_SEL,
             ---- serial interface ----
             spi_ssel_o => CS,
             spi_sck_o  => SCK,
@@ -0,0 +1,62 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Interrupt line of the screen IP
+-- Bit 0 (POWER) is set when ON_OFF_STATUS settles in 00 (OFF) or 11 (ON) after a transition,
+-- bit 1 (TX_IDLE) when the TX queue has run empty and the last byte has left the SPI master.
+-- A pending bit stays set until it is acknowledged, an event in the same cycle as its
+-- acknowledge sets it again. IRQ is high while an enabled bit is pending (level sensitive).
+entity screen_irq is
+    Port (
+        -- Sync
+        CLK    : in std_logic;
+        RESETN : in std_logic;
+
+        -- Events
+        ON_OFF_STATUS : in std_logic_vector(1 downto 0);
+        TX_IDLE       : in std_logic;
+
+        -- IRQ_ENABLE and IRQ_STATUS of the AXI slave, IRQ_ACK is high for one cycle per write
+        IRQ_ENABLE : in  std_logic_vector(1 downto 0);
+        IRQ_ACK    : in  std_logic_vector(1 downto 0);
+        IRQ_STATUS : out std_logic_vector(1 downto 0);
+
+        -- Interrupt, level high
+        IRQ : out std_logic
+    );
+end screen_irq;
+
+architecture Behavioral of screen_irq is
+
+    signal on_off_status_prev : std_logic_vector(1 downto 0);
+    signal tx_idle_prev       : std_logic;
+    signal events             : std_logic_vector(1 downto 0);
+    signal pending            : std_logic_vector(1 downto 0);
+
+begin
+
+    -- Only the end of a transition, 01 and 10 are the way there
+    events(0) <= '1' when (ON_OFF_STATUS /= on_off_status_prev and (ON_OFF_STATUS = "00" or ON_OFF_STATUS = "11")) else '0';
+    events(1) <= TX_IDLE and not tx_idle_prev;
+
+    process(CLK)
+    begin
+        if rising_edge(CLK) then
+            if (RESETN = '0') then
+                -- The queue is idle after reset, which is no event
+                on_off_status_prev <= "00";
+                tx_idle_prev       <= '1';
+                pending            <= "00";
+            else
+                on_off_status_prev <= ON_OFF_STATUS;
+                tx_idle_prev       <= TX_IDLE;
+                pending            <= (pending and not IRQ_ACK) or events;
+            end if;
+        end if;
+    end process;
+
+    IRQ_STATUS <= pending;
+    IRQ        <= '1' when ((pending and IRQ_ENABLE) /= "00") else '0';
+
+end Behavioral;
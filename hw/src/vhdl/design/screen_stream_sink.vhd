@@ -0,0 +1,63 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- AXI-Stream sink in front of the TX queue
+-- Every beat of the stream (e.g. an AXI DMA reading a frame from DDR) is one queue entry of
+-- data bytes, byte 0 (bits 7:0) first, so a buffer is sent in memory order. TKEEP marks the
+-- valid bytes of the last beat, which must be the lower ones, and a null beat (TKEEP "0000")
+-- is taken without pushing anything. The pushes of the AXI slave
+-- (commands and bursts) take the queue first, and the stream waits while it is full.
+-- TLAST is accepted but not used, frames are delimited by the commands around them.
+entity screen_stream_sink is
+    Port (
+        -- AXI-Stream slave, same clock as the queue
+        S_AXIS_TDATA  : in  std_logic_vector(31 downto 0);
+        S_AXIS_TKEEP  : in  std_logic_vector(3 downto 0);
+        S_AXIS_TLAST  : in  std_logic;
+        S_AXIS_TVALID : in  std_logic;
+        S_AXIS_TREADY : out std_logic;
+
+        -- Pushes of the AXI slave
+        TX_PUSH  : in std_logic;
+        TX_DATA  : in std_logic_vector(31 downto 0);
+        TX_DC    : in std_logic_vector(3 downto 0);
+        TX_COUNT : in std_logic_vector(1 downto 0);
+
+        -- TX queue push interface
+        FIFO_FULL  : in  std_logic;
+        PUSH       : out std_logic;
+        PUSH_DATA  : out std_logic_vector(31 downto 0);
+        PUSH_DC    : out std_logic_vector(3 downto 0);
+        PUSH_COUNT : out std_logic_vector(1 downto 0)
+    );
+end screen_stream_sink;
+
+architecture Behavioral of screen_stream_sink is
+
+    signal ready       : std_logic;
+    signal keep_any    : std_logic;
+    signal stream_push : std_logic;
+    signal keep_count  : std_logic_vector(1 downto 0);
+
+begin
+
+    -- A beat is taken in the same cycle it is pushed, never together with a write of the AXI slave
+    ready       <= not FIFO_FULL and not TX_PUSH;
+    keep_any    <= '0' when (S_AXIS_TKEEP = "0000") else '1';
+    stream_push <= S_AXIS_TVALID and ready and keep_any;
+
+    with S_AXIS_TKEEP select
+        keep_count <= "11" when "1111",
+                      "10" when "0111",
+                      "01" when "0011",
+                      "00" when others;
+
+    S_AXIS_TREADY <= ready;
+
+    PUSH       <= TX_PUSH or stream_push;
+    PUSH_DATA  <= TX_DATA    when (TX_PUSH = '1') else S_AXIS_TDATA;
+    PUSH_DC    <= TX_DC      when (TX_PUSH = '1') else "1111";
+    PUSH_COUNT <= TX_COUNT   when (TX_PUSH = '1') else keep_count;
+
+end Behavioral;
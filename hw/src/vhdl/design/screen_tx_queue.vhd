@@ -0,0 +1,179 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- TX queue between the AXI slave and the screen_controller
+-- Each entry holds up to 4 bytes with their D/C flags, written by one AXI write.
+-- Bytes are sent from the lowest lane up, one at a time: the next byte is triggered
+-- once the screen_controller reports the previous one finished (SPI_READY).
+entity screen_tx_queue is
+    Generic (
+        FIFO_DEPTH : positive := 16 -- Entries (words) the queue can hold
+    );
+    Port (
+        -- Sync
+        CLK    : in std_logic;
+        RESETN : in std_logic;
+
+        -- Push interface (AXI slave)
+        PUSH       : in std_logic;
+        PUSH_DATA  : in std_logic_vector(31 downto 0); -- Byte 0 in bits 7:0 is sent first
+        PUSH_DC    : in std_logic_vector(3 downto 0);  -- DC_SELECT of each byte, bit 0 for byte 0
+        PUSH_COUNT : in std_logic_vector(1 downto 0);  -- Bytes in the entry minus one
+
+        -- Queue status
+        FIFO_LEVEL : out std_logic_vector(15 downto 0);
+        FIFO_EMPTY : out std_logic;
+        FIFO_FULL  : out std_logic;
+        FIFO_OVERFLOW : out std_logic; -- High for one cycle when a push finds the queue full and is dropped
+        TX_IDLE    : out std_logic; -- Queue empty and the last byte finished
+
+        -- screen_controller interface
+        SPI_READY   : in  std_logic;
+        SPI_TRIGGER : out std_logic;
+        BYTE        : out std_logic_vector(7 downto 0);
+        DC_SELECT   : out std_logic
+    );
+end screen_tx_queue;
+
+architecture Behavioral of screen_tx_queue is
+
+    -- Entry: count (37:36), D/C flags (35:32), bytes (31:0)
+    subtype fifo_entry is std_logic_vector(37 downto 0);
+    type fifo_memory is array(0 to FIFO_DEPTH - 1) of fifo_entry;
+
+    signal fifo      : fifo_memory := (others => (others => '0'));
+    signal wr_ptr    : integer range 0 to FIFO_DEPTH - 1 := 0;
+    signal rd_ptr    : integer range 0 to FIFO_DEPTH - 1 := 0;
+    signal level     : integer range 0 to FIFO_DEPTH := 0;
+    signal empty     : std_logic;
+    signal full      : std_logic;
+    signal pop       : std_logic;
+    signal push_used : std_logic;
+
+    -- Unpacker State Machine
+    -- unpack_trigger: present the byte and trigger it when the controller is idle
+    -- unpack_wait_busy: wait for the controller to take the byte (SPI_READY falls)
+    -- unpack_wait_done: wait for the byte to finish, then move to the next one
+    type   unpack_states is (unpack_idle, unpack_trigger, unpack_wait_busy, unpack_wait_done);
+    signal unpack_state : unpack_states := unpack_idle;
+
+    signal tx_bytes     : std_logic_vector(31 downto 0) := (others => '0');
+    signal tx_dc        : std_logic_vector(3 downto 0) := (others => '0');
+    signal tx_remaining : unsigned(1 downto 0) := (others => '0');
+
+    -- Registered outputs, stable for the whole byte
+    signal byte_reg    : std_logic_vector(7 downto 0) := (others => '0');
+    signal dc_reg      : std_logic := '0';
+    signal trigger_reg : std_logic := '0';
+
+begin
+
+    empty <= '1' when (level = 0) else '0';
+    full  <= '1' when (level = FIFO_DEPTH) else '0';
+
+    -- Writes into a full queue are dropped and reported, the driver checks FIFO_LEVEL first
+    push_used <= PUSH and not full;
+    pop       <= '1' when (unpack_state = unpack_idle and empty = '0') else '0';
+
+    -- FIFO storage and pointers
+    fifo_proc: process(CLK)
+    begin
+        if (rising_edge(CLK)) then
+            if (RESETN = '0') then
+                wr_ptr <= 0;
+                rd_ptr <= 0;
+                level  <= 0;
+            else
+                if (push_used = '1') then
+                    fifo(wr_ptr) <= PUSH_COUNT & PUSH_DC & PUSH_DATA;
+                    if (wr_ptr = FIFO_DEPTH - 1) then
+                        wr_ptr <= 0;
+                    else
+                        wr_ptr <= wr_ptr + 1;
+                    end if;
+                end if;
+
+                if (pop = '1') then
+                    if (rd_ptr = FIFO_DEPTH - 1) then
+                        rd_ptr <= 0;
+                    else
+                        rd_ptr <= rd_ptr + 1;
+                    end if;
+                end if;
+
+                if (push_used = '1' and pop = '0') then
+                    level <= level + 1;
+                elsif (push_used = '0' and pop = '1') then
+                    level <= level - 1;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    -- Unpacker: one entry at a time, one byte at a time
+    tx_proc: process(CLK)
+    begin
+        if (rising_edge(CLK)) then
+            if (RESETN = '0') then
+                tx_bytes     <= (others => '0');
+                tx_dc        <= (others => '0');
+                tx_remaining <= (others => '0');
+                byte_reg     <= (others => '0');
+                dc_reg       <= '0';
+                trigger_reg  <= '0';
+                unpack_state <= unpack_idle;
+            else
+                case unpack_state is
+
+                    when unpack_idle =>
+                        trigger_reg <= '0';
+                        if (pop = '1') then
+                            tx_bytes     <= fifo(rd_ptr)(31 downto 0);
+                            tx_dc        <= fifo(rd_ptr)(35 downto 32);
+                            tx_remaining <= unsigned(fifo(rd_ptr)(37 downto 36));
+                            unpack_state <= unpack_trigger;
+                        end if;
+
+                    when unpack_trigger =>
+                        byte_reg <= tx_bytes(7 downto 0);
+                        dc_reg   <= tx_dc(0);
+                        if (SPI_READY = '1') then
+                            trigger_reg  <= '1';
+                            unpack_state <= unpack_wait_busy;
+                        end if;
+
+                    when unpack_wait_busy =>
+                        trigger_reg <= '0';
+                        if (SPI_READY = '0') then
+                            unpack_state <= unpack_wait_done;
+                        end if;
+
+                    when unpack_wait_done =>
+                        if (SPI_READY = '1') then
+                            if (tx_remaining = 0) then
+                                unpack_state <= unpack_idle;
+                            else
+                                tx_bytes     <= x"00" & tx_bytes(31 downto 8);
+                                tx_dc        <= '0' & tx_dc(3 downto 1);
+                                tx_remaining <= tx_remaining - 1;
+                                unpack_state <= unpack_trigger;
+                            end if;
+                        end if;
+
+                end case;
+            end if;
+        end if;
+    end process;
+
+    FIFO_LEVEL <= std_logic_vector(to_unsigned(level, 16));
+    FIFO_EMPTY <= empty;
+    FIFO_FULL  <= full;
+    FIFO_OVERFLOW <= PUSH and full;
+    TX_IDLE    <= '1' when (unpack_state = unpack_idle and empty = '1' and SPI_READY = '1') else '0';
+
+    SPI_TRIGGER <= trigger_reg;
+    BYTE        <= byte_reg;
+    DC_SELECT   <= dc_reg;
+
+end Behavioral;
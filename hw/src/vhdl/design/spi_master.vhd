@@ -149,6 +149,7 @@
 -- 2011/08/04   v1.15.0136  [JD]    Fixed assertions (PREFETCH >= 1) and minor comment bugs.
 --
 -- added done_o signal to ensure chip select deassert between transfers
+-- added clk_div_i port to change the SCK divider at runtime, 0 keeps the SPI_2X_CLK_DIV generic
 -----------------------------------------------------------------------------------------------------------------------
 --  TODO
 --  ====
@@ -183,6 +184,7 @@ entity spi_master is
         sclk_i : in std_logic := 'X'; -- high-speed serial interface system clock
         pclk_i : in std_logic := 'X'; -- high-speed parallel interface system clock
         rst_i  : in std_logic := 'X'; -- reset core
+        clk_div_i : in std_logic_vector (7 downto 0) := (others => '0'); -- runtime SPI_2X_CLK_DIV, 0 selects the generic
         ---- serial interface ----
         spi_ssel_o : out std_logic;        -- spi bus slave select line
         spi_sck_o  : out std_logic;        -- spi bus sck
@@ -223,6 +225,7 @@ architecture rtl of spi_master is
     signal core_n_ce    : std_logic := '1';     -- core clock enable, negative logic
     -- spi bus clock, generated from the CPOL selected core clock polarity
     signal spi_2x_ce    : std_logic := '1';     -- spi_2x clock enable
+    signal spi_2x_div   : integer range 1 to 255 := 1; -- effective spi_2x clock divider
     signal spi_clk      : std_logic := '0';     -- spi bus output clock
     signal spi_clk_reg  : std_logic;            -- output pipeline delay for spi sck (do NOT global initialize)
     -- core fsm clock enables
@@ -305,6 +308,10 @@ begin
     assert SPI_2X_CLK_DIV > 0
     report "Generic parameter 'SPI_2X_CLK_DIV' must not be zero"
     severity FAILURE;
+    -- SPI_2X_CLK_DIV clock divider value must fit the clk_div_i range
+    assert SPI_2X_CLK_DIV <= 255
+    report "Generic parameter 'SPI_2X_CLK_DIV' out of range, needs to be 255 maximum"
+    severity FAILURE;
 
     --=============================================================================================
     --  CLOCK GENERATION
@@ -324,11 +331,15 @@ begin
     -- modes, by a single high-speed global clock, preserving clock resources and clock to data skew.
     -----------------------------------------------------------------------------------------------
     -- generate the 2x spi base clock enable from the serial high-speed input clock
+    -- an uninitialized clk_div_i (register not reset yet) converts to 0 and keeps the generic
+    spi_2x_div <= SPI_2X_CLK_DIV when to_integer(unsigned(clk_div_i)) = 0 else to_integer(unsigned(clk_div_i));
+
     spi_2x_ce_gen_proc: process (sclk_i) is
-        variable clk_cnt : integer range SPI_2X_CLK_DIV-1 downto 0 := 0;
+        variable clk_cnt : integer range 254 downto 0 := 0;
     begin
         if sclk_i'event and sclk_i = '1' then
-            if clk_cnt = SPI_2X_CLK_DIV-1 then
+            -- a divider lowered during a count ends the period at once
+            if clk_cnt >= spi_2x_div-1 then
                 spi_2x_ce <= '1';
                 clk_cnt := 0;
             else
@@ -99,6 +99,9 @@ begin
             BYTE      => byte,
             DC_SELECT => dc_select,
 
+            -- SCK divider, the standalone tester keeps the default 6.25MHz SCK
+            SPI_CLK_DIV_SEL => (others => '0'),
+
             -- Pmod physical pins
             MOSI         => mosi,
             SCK          => sck,
@@ -29,6 +29,9 @@ architecture Behavioral of screen_controller_tb is
             BYTE      : in  std_logic_vector(7 downto 0);
             DC_SELECT : in  std_logic;
 
+            -- SCK divider
+            SPI_CLK_DIV_SEL : in std_logic_vector(7 downto 0);
+
             -- Pmod physical pins
             MOSI         : out std_logic;
             SCK          : out std_logic;
@@ -89,6 +92,9 @@ begin
             -- Data input
             BYTE      => byte,
             DC_SELECT => dc_select,
+
+            -- SCK divider, 0 keeps the default 6.25MHz SCK
+            SPI_CLK_DIV_SEL => (others => '0'),
     
             -- Pmod physical pins
             MOSI         => mosi,
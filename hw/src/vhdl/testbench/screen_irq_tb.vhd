@@ -0,0 +1,189 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Self-checking: the power source is only set at the end of a transition and the TX idle source
+-- on the rising edge of TX_IDLE, pending sources stay set until acknowledged whether enabled or
+-- not, irq follows the enabled pending sources, and an event in the cycle of its acknowledge wins
+entity screen_irq_tb is
+    -- Port ( );
+end screen_irq_tb;
+
+architecture Behavioral of screen_irq_tb is
+
+    -- Component Under Test
+    component screen_irq is
+        Port (
+            -- Sync
+            CLK    : in std_logic;
+            RESETN : in std_logic;
+
+            -- Events
+            ON_OFF_STATUS : in std_logic_vector(1 downto 0);
+            TX_IDLE       : in std_logic;
+
+            -- IRQ_ENABLE and IRQ_STATUS of the AXI slave, IRQ_ACK is high for one cycle per write
+            IRQ_ENABLE : in  std_logic_vector(1 downto 0);
+            IRQ_ACK    : in  std_logic_vector(1 downto 0);
+            IRQ_STATUS : out std_logic_vector(1 downto 0);
+
+            -- Interrupt, level high
+            IRQ : out std_logic
+        );
+    end component;
+
+    -- Clock
+    constant clk_period : time := 8 ns;
+
+    -- Signals
+    signal clk    : std_logic := '0';
+    signal resetn : std_logic := '0';
+    signal done   : boolean := false;
+
+    signal on_off_status : std_logic_vector(1 downto 0) := "00";
+    signal tx_idle       : std_logic := '1';
+    signal irq_enable    : std_logic_vector(1 downto 0) := "00";
+    signal irq_ack       : std_logic_vector(1 downto 0) := "00";
+    signal irq_status    : std_logic_vector(1 downto 0) := "00";
+    signal irq           : std_logic := '0';
+
+    signal checks : natural := 0;
+
+begin
+
+    -- Port Map
+    CUT : screen_irq
+        Port Map (
+            -- Sync
+            CLK    => clk,
+            RESETN => resetn,
+
+            -- Events
+            ON_OFF_STATUS => on_off_status,
+            TX_IDLE       => tx_idle,
+
+            -- IRQ_ENABLE and IRQ_STATUS of the AXI slave, IRQ_ACK is high for one cycle per write
+            IRQ_ENABLE => irq_enable,
+            IRQ_ACK    => irq_ack,
+            IRQ_STATUS => irq_status,
+
+            -- Interrupt, level high
+            IRQ => irq
+        );
+
+    clk_proc : process
+    begin
+        if (done) then
+            wait;
+        end if;
+        clk <= '0';
+        wait for clk_period/2;
+        clk <= '1';
+        wait for clk_period/2;
+    end process;
+
+    stim_proc : process
+
+        procedure tick is
+        begin
+            wait until rising_edge(clk);
+            wait for 1 ns;
+        end procedure;
+
+        procedure check (
+            constant status   : in std_logic_vector(1 downto 0);
+            constant expected : in std_logic;
+            constant step     : in string
+        ) is
+        begin
+            assert irq_status = status
+                report step & ": IRQ_STATUS differs from the expected one" severity error;
+            assert irq = expected
+                report step & ": irq differs from the expected level" severity error;
+            checks <= checks + 1;
+        end procedure;
+
+        procedure acknowledge (
+            constant sources : in std_logic_vector(1 downto 0)
+        ) is
+        begin
+            irq_ack <= sources;
+            tick;
+            irq_ack <= "00";
+        end procedure;
+
+    begin
+        wait for 5*clk_period;
+            resetn <= '1';
+        tick;
+        check("00", '0', "After reset");
+
+        -- Power on with the sources disabled: set at the end of the transition only, no irq
+        on_off_status <= "01";
+        tick;
+        tick;
+        check("00", '0', "Turning on");
+        on_off_status <= "11";
+        tick;
+        check("01", '0', "On, disabled");
+
+        -- Enabling a pending source raises irq, its acknowledge lowers it
+        irq_enable <= "01";
+        wait for 1 ns;
+        check("01", '1', "On, enabled");
+        acknowledge("01");
+        check("00", '0', "On, acknowledged");
+
+        -- Bytes sent: only the return to idle is an event, the busy time is not
+        tx_idle <= '0';
+        tick;
+        tick;
+        check("00", '0', "TX busy");
+        tx_idle <= '1';
+        tick;
+        check("10", '0', "TX idle, disabled");
+        irq_enable <= "11";
+        wait for 1 ns;
+        check("10", '1', "TX idle, enabled");
+
+        -- Acknowledging the other source leaves it pending
+        acknowledge("01");
+        check("10", '1', "TX idle, power acknowledged");
+        acknowledge("10");
+        check("00", '0', "TX idle, acknowledged");
+
+        -- Event in the cycle of the acknowledge: it is not lost
+        tx_idle <= '0';
+        tick;
+        tick;
+        tx_idle <= '1';
+        irq_ack <= "10";
+        tick;
+        irq_ack <= "00";
+        check("10", '1', "TX idle during the acknowledge");
+        acknowledge("10");
+
+        -- Power off raises the power source again
+        on_off_status <= "10";
+        tick;
+        check("00", '0', "Turning off");
+        on_off_status <= "00";
+        tick;
+        check("01", '1', "Off");
+
+        -- Disabling drops irq and keeps the source pending
+        irq_enable <= "00";
+        wait for 1 ns;
+        check("01", '0', "Off, disabled");
+        acknowledge("11");
+        check("00", '0', "Off, acknowledged");
+
+        -- Let the last check count
+        wait for 1 ns;
+        report "screen_irq_tb finished, " & integer'image(checks) & " checks" severity note;
+
+        done <= true;
+        wait;
+    end process;
+
+end Behavioral;
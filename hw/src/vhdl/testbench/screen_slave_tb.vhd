@@ -0,0 +1,469 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Self-checking: SPI_CTRL and SPI_BURST writes through the AXI slave must each push one entry in
+-- the cycle after the write, also back to back, the bytes shifted out on MOSI are compared with
+-- the written ones, a write into the full queue sets FIFO_OVERFLOW until it is written with 1,
+-- SPI_READY in SPI_STATUS follows TX_IDLE of the queue, and the IRQ_ENABLE and IRQ_STATUS
+-- registers drive irq through screen_irq, all wired as in screen.vhd
+entity screen_slave_tb is
+    Generic (
+        FIFO_DEPTH     : positive := 4; -- Small so the full queue is reached quickly
+        SPI_2X_CLK_DIV : positive := 2  -- Faster SCK than the IP to keep the simulation short
+    );
+    -- Port ( );
+end screen_slave_tb;
+
+architecture Behavioral of screen_slave_tb is
+
+    -- Component Under Test
+    component screen_slave_lite_v2_0_S00_AXI is
+        Generic (
+            FIFO_DEPTH  : integer := 16;
+            SPI_CLK_DIV : integer := 10;
+            C_S_AXI_DATA_WIDTH : integer := 32;
+            C_S_AXI_ADDR_WIDTH : integer := 6
+        );
+        Port (
+            -- Control
+            ON_OFF           : out std_logic;
+            -- Status
+            ON_OFF_STATUS    : in std_logic_vector(1 downto 0);
+            SPI_READY        : in std_logic;
+            SPI_DATA_REQUEST : in std_logic;
+            -- TX queue push
+            TX_PUSH  : out std_logic;
+            TX_DATA  : out std_logic_vector(31 downto 0);
+            TX_DC    : out std_logic_vector(3 downto 0);
+            TX_COUNT : out std_logic_vector(1 downto 0);
+            -- TX queue status
+            FIFO_LEVEL    : in std_logic_vector(15 downto 0);
+            FIFO_EMPTY    : in std_logic;
+            FIFO_FULL     : in std_logic;
+            FIFO_OVERFLOW : in std_logic;
+            -- SCK divider
+            SPI_CLK_DIV_SEL : out std_logic_vector(7 downto 0);
+            -- Interrupt sources
+            IRQ_ENABLE : out std_logic_vector(1 downto 0);
+            IRQ_ACK    : out std_logic_vector(1 downto 0);
+            IRQ_STATUS : in  std_logic_vector(1 downto 0);
+            -- AXI4-Lite slave
+            S_AXI_ACLK    : in  std_logic;
+            S_AXI_ARESETN : in  std_logic;
+            S_AXI_AWADDR  : in  std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            S_AXI_AWPROT  : in  std_logic_vector(2 downto 0);
+            S_AXI_AWVALID : in  std_logic;
+            S_AXI_AWREADY : out std_logic;
+            S_AXI_WDATA   : in  std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+            S_AXI_WSTRB   : in  std_logic_vector((C_S_AXI_DATA_WIDTH/8)-1 downto 0);
+            S_AXI_WVALID  : in  std_logic;
+            S_AXI_WREADY  : out std_logic;
+            S_AXI_BRESP   : out std_logic_vector(1 downto 0);
+            S_AXI_BVALID  : out std_logic;
+            S_AXI_BREADY  : in  std_logic;
+            S_AXI_ARADDR  : in  std_logic_vector(C_S_AXI_ADDR_WIDTH-1 downto 0);
+            S_AXI_ARPROT  : in  std_logic_vector(2 downto 0);
+            S_AXI_ARVALID : in  std_logic;
+            S_AXI_ARREADY : out std_logic;
+            S_AXI_RDATA   : out std_logic_vector(C_S_AXI_DATA_WIDTH-1 downto 0);
+            S_AXI_RRESP   : out std_logic_vector(1 downto 0);
+            S_AXI_RVALID  : out std_logic;
+            S_AXI_RREADY  : in  std_logic
+        );
+    end component;
+
+    -- Clock
+    constant clk_period : time := 8 ns;
+
+    -- Registers, word index
+    constant SPI_CTRL   : natural := 2;
+    constant SPI_STATUS : natural := 3;
+    constant SPI_BURST  : natural := 4;
+    constant BURST_CTRL : natural := 5;
+    constant IRQ_ENABLE_REG : natural := 10; -- Suffixed, the names are taken by the screen_irq signals
+    constant IRQ_STATUS_REG : natural := 11;
+
+    -- Expected bytes on the SPI bus
+    type tx_byte is record
+        byte : std_logic_vector(7 downto 0);
+        dc   : std_logic;
+    end record;
+    type tx_sequence is array(natural range <>) of tx_byte;
+
+    constant EXPECTED : tx_sequence := (
+        -- SPI_CTRL, single command byte
+        (x"15", '0'),
+        -- SPI_BURST, four data bytes, lowest lane first
+        (x"11", '1'), (x"22", '1'), (x"33", '1'), (x"44", '1'),
+        -- SPI_CTRL followed by SPI_BURST in the next cycle
+        (x"AA", '1'), (x"BB", '0'),
+        -- SPI_BURST back to back until the queue is full, the last write (x"C5") is dropped
+        (x"C0", '1'), (x"C1", '1'), (x"C2", '1'), (x"C3", '1'), (x"C4", '1')
+    );
+
+    -- Signals
+    signal clk    : std_logic := '0';
+    signal resetn : std_logic := '0';
+    signal done   : boolean := false;
+
+    signal awaddr  : std_logic_vector(5 downto 0) := (others => '0');
+    signal awvalid : std_logic := '0';
+    signal awready : std_logic := '0';
+    signal wdata   : std_logic_vector(31 downto 0) := (others => '0');
+    signal wvalid  : std_logic := '0';
+    signal araddr  : std_logic_vector(5 downto 0) := (others => '0');
+    signal arvalid : std_logic := '0';
+    signal arready : std_logic := '0';
+    signal rdata   : std_logic_vector(31 downto 0) := (others => '0');
+    signal rvalid  : std_logic := '0';
+
+    signal tx_push  : std_logic := '0';
+    signal tx_data  : std_logic_vector(31 downto 0) := (others => '0');
+    signal tx_dc    : std_logic_vector(3 downto 0) := (others => '0');
+    signal tx_count : std_logic_vector(1 downto 0) := (others => '0');
+
+    signal fifo_level    : std_logic_vector(15 downto 0) := (others => '0');
+    signal fifo_empty    : std_logic := '0';
+    signal fifo_full     : std_logic := '0';
+    signal fifo_overflow : std_logic := '0';
+    signal tx_idle       : std_logic := '0';
+
+    signal on_off_status : std_logic_vector(1 downto 0) := "00";
+    signal irq_enable    : std_logic_vector(1 downto 0) := (others => '0');
+    signal irq_ack       : std_logic_vector(1 downto 0) := (others => '0');
+    signal irq_status    : std_logic_vector(1 downto 0) := (others => '0');
+    signal irq           : std_logic := '0';
+
+    signal spi_ready   : std_logic := '0';
+    signal spi_trigger : std_logic := '0';
+    signal byte        : std_logic_vector(7 downto 0) := (others => '0');
+    signal dc_select   : std_logic := '0';
+
+    signal rst  : std_logic := '1';
+    signal mosi : std_logic := '0';
+    signal sck  : std_logic := '0';
+    signal cs   : std_logic := '1';
+
+    signal received : natural := 0;
+    signal pushes   : natural := 0;
+
+begin
+
+    -- Port Map
+    CUT : screen_slave_lite_v2_0_S00_AXI
+        Generic Map (
+            FIFO_DEPTH  => FIFO_DEPTH,
+            SPI_CLK_DIV => SPI_2X_CLK_DIV
+        )
+        Port Map (
+            -- Control
+            ON_OFF           => open,
+            -- Status
+            ON_OFF_STATUS    => on_off_status,
+            SPI_READY        => tx_idle,
+            SPI_DATA_REQUEST => '0',
+            -- TX queue push
+            TX_PUSH  => tx_push,
+            TX_DATA  => tx_data,
+            TX_DC    => tx_dc,
+            TX_COUNT => tx_count,
+            -- TX queue status
+            FIFO_LEVEL    => fifo_level,
+            FIFO_EMPTY    => fifo_empty,
+            FIFO_FULL     => fifo_full,
+            FIFO_OVERFLOW => fifo_overflow,
+            -- SCK divider
+            SPI_CLK_DIV_SEL => open,
+            -- Interrupt sources
+            IRQ_ENABLE => irq_enable,
+            IRQ_ACK    => irq_ack,
+            IRQ_STATUS => irq_status,
+            -- AXI4-Lite slave
+            S_AXI_ACLK    => clk,
+            S_AXI_ARESETN => resetn,
+            S_AXI_AWADDR  => awaddr,
+            S_AXI_AWPROT  => "000",
+            S_AXI_AWVALID => awvalid,
+            S_AXI_AWREADY => awready,
+            S_AXI_WDATA   => wdata,
+            S_AXI_WSTRB   => "1111",
+            S_AXI_WVALID  => wvalid,
+            S_AXI_WREADY  => open,
+            S_AXI_BRESP   => open,
+            S_AXI_BVALID  => open,
+            S_AXI_BREADY  => '1',
+            S_AXI_ARADDR  => araddr,
+            S_AXI_ARPROT  => "000",
+            S_AXI_ARVALID => arvalid,
+            S_AXI_ARREADY => arready,
+            S_AXI_RDATA   => rdata,
+            S_AXI_RRESP   => open,
+            S_AXI_RVALID  => rvalid,
+            S_AXI_RREADY  => '1'
+        );
+
+    -- TX queue and SPI master between the slave and the Pmod pins, as in screen.vhd
+    screen_tx_queue_inst: entity work.screen_tx_queue
+        Generic Map (
+            FIFO_DEPTH => FIFO_DEPTH
+        )
+        Port Map (
+            CLK    => clk,
+            RESETN => resetn,
+
+            PUSH       => tx_push,
+            PUSH_DATA  => tx_data,
+            PUSH_DC    => tx_dc,
+            PUSH_COUNT => tx_count,
+
+            FIFO_LEVEL    => fifo_level,
+            FIFO_EMPTY    => fifo_empty,
+            FIFO_FULL     => fifo_full,
+            FIFO_OVERFLOW => fifo_overflow,
+            TX_IDLE       => tx_idle,
+
+            SPI_READY   => spi_ready,
+            SPI_TRIGGER => spi_trigger,
+            BYTE        => byte,
+            DC_SELECT   => dc_select
+        );
+
+    spi_master_inst: entity work.spi_master
+        Generic Map (
+            N              => 8,
+            CPOL           => '1',
+            CPHA           => '1',
+            PREFETCH       => 2,
+            SPI_2X_CLK_DIV => SPI_2X_CLK_DIV
+        )
+        Port Map (
+            sclk_i => clk,
+            pclk_i => clk,
+            rst_i  => rst,
+            ---- serial interface ----
+            spi_ssel_o => cs,
+            spi_sck_o  => sck,
+            spi_mosi_o => mosi,
+            spi_miso_i => '0',
+            ---- parallel interface ----
+            di_req_o   => open,
+            di_i       => byte,
+            wren_i     => spi_trigger,
+            wr_ack_o   => open,
+            do_valid_o => open,
+            do_o       => open,
+            done_o     => spi_ready
+        );
+
+    screen_irq_inst: entity work.screen_irq
+        Port Map (
+            CLK    => clk,
+            RESETN => resetn,
+
+            ON_OFF_STATUS => on_off_status,
+            TX_IDLE       => tx_idle,
+
+            IRQ_ENABLE => irq_enable,
+            IRQ_ACK    => irq_ack,
+            IRQ_STATUS => irq_status,
+
+            IRQ => irq
+        );
+
+    rst <= not resetn;
+
+    clk_proc : process
+    begin
+        if (done) then
+            wait;
+        end if;
+        clk <= '0';
+        wait for clk_period/2;
+        clk <= '1';
+        wait for clk_period/2;
+    end process;
+
+    -- SPI receiver, bits sampled on the rising edge of SCK (CPOL = CPHA = '1')
+    monitor_proc : process
+        variable shift : std_logic_vector(7 downto 0);
+    begin
+        for i in EXPECTED'range loop
+            for b in 7 downto 0 loop
+                wait until rising_edge(sck) and cs = '0';
+                shift(b) := mosi;
+            end loop;
+            assert shift = EXPECTED(i).byte
+                report "Byte " & integer'image(i) & " differs from the written one" severity error;
+            assert dc_select = EXPECTED(i).dc
+                report "D/C of byte " & integer'image(i) & " differs from the written one" severity error;
+            received <= i + 1;
+        end loop;
+        wait;
+    end process;
+
+    -- Entries pushed by the slave
+    push_proc : process(clk)
+    begin
+        if (rising_edge(clk)) then
+            if (tx_push = '1') then
+                pushes <= pushes + 1;
+            end if;
+        end if;
+    end process;
+
+    stim_proc : process
+
+        -- Address and data in the same cycle, accepted at once while the slave waits for an address
+        procedure axi_write (
+            constant reg  : in natural;
+            constant data : in std_logic_vector(31 downto 0)
+        ) is
+        begin
+            awaddr  <= std_logic_vector(to_unsigned(reg * 4, 6));
+            awvalid <= '1';
+            wdata   <= data;
+            wvalid  <= '1';
+            wait until rising_edge(clk) and awready = '1';
+            awvalid <= '0';
+            wvalid  <= '0';
+        end procedure;
+
+        -- The masked read data must match, checked in the cycle RVALID is high
+        procedure axi_check (
+            constant reg      : in natural;
+            constant mask     : in std_logic_vector(31 downto 0);
+            constant expected : in std_logic_vector(31 downto 0);
+            constant msg      : in string
+        ) is
+        begin
+            araddr  <= std_logic_vector(to_unsigned(reg * 4, 6));
+            arvalid <= '1';
+            wait until rising_edge(clk) and arready = '1';
+            arvalid <= '0';
+            wait until rising_edge(clk) and rvalid = '1';
+            assert (rdata and mask) = expected
+                report msg severity error;
+        end procedure;
+
+        -- The entry must be on TX_PUSH in the cycle after the write
+        procedure check_push (
+            constant data  : in std_logic_vector(31 downto 0);
+            constant dc    : in std_logic_vector(3 downto 0);
+            constant count : in std_logic_vector(1 downto 0);
+            constant msg   : in string
+        ) is
+        begin
+            wait until rising_edge(clk);
+            assert tx_push = '1' and tx_data = data and tx_dc = dc and tx_count = count
+                report msg & " not pushed in the cycle after the write" severity error;
+        end procedure;
+
+        procedure wait_tx_idle is
+        begin
+            wait until rising_edge(clk);
+            wait until rising_edge(clk);
+            if (tx_idle = '0') then
+                wait until tx_idle = '1';
+            end if;
+            wait until rising_edge(clk);
+            wait until rising_edge(clk);
+        end procedure;
+
+    begin
+        wait for 5*clk_period;
+            resetn <= '1';
+        wait for 20*clk_period;
+        wait until rising_edge(clk);
+
+        axi_check(SPI_STATUS, x"0000001F", x"00000005", "SPI_READY and FIFO_EMPTY not set after reset");
+
+        -- SPI_CTRL without SPI_TRIGGER only stores the byte
+        axi_write(SPI_CTRL, x"00000015");
+        wait for 10*clk_period;
+        assert pushes = 0
+            report "SPI_CTRL write without SPI_TRIGGER pushed an entry" severity error;
+
+        -- SPI_CTRL with SPI_TRIGGER, then SPI_READY must fall while the byte is sent
+        axi_write(SPI_CTRL, x"00000215");
+        check_push(x"00000015", "0000", "00", "SPI_CTRL byte");
+        axi_check(SPI_STATUS, x"00000001", x"00000000", "SPI_READY set while the TX queue is busy");
+        wait_tx_idle;
+        axi_check(SPI_STATUS, x"00000001", x"00000001", "SPI_READY not set once the TX queue is idle");
+
+        -- SPI_BURST with the count and D/C flags of BURST_CTRL
+        axi_write(BURST_CTRL, x"000000F3");
+        axi_write(SPI_BURST, x"44332211");
+        check_push(x"44332211", "1111", "11", "SPI_BURST entry");
+        wait_tx_idle;
+
+        -- SPI_CTRL and SPI_BURST in consecutive cycles must push both entries
+        axi_write(BURST_CTRL, x"00000000");
+        axi_write(SPI_CTRL, x"000003AA");
+        axi_write(SPI_BURST, x"000000BB");
+        wait until rising_edge(clk);
+        wait until rising_edge(clk);
+        assert pushes = 4
+            report integer'image(pushes) & " entries pushed instead of 4 after back to back writes" severity error;
+        wait_tx_idle;
+
+        -- The TX idle source is pending but disabled, irq follows it once enabled until acknowledged
+        axi_check(IRQ_STATUS_REG, x"00000003", x"00000002", "IRQ_TX_IDLE not pending after the bytes were sent");
+        assert irq = '0'
+            report "irq high with no source enabled" severity error;
+        axi_write(IRQ_ENABLE_REG, x"00000002");
+        wait until rising_edge(clk);
+        wait until rising_edge(clk);
+        assert irq = '1'
+            report "irq low with IRQ_TX_IDLE pending and enabled" severity error;
+        axi_write(IRQ_STATUS_REG, x"00000002");
+        wait until rising_edge(clk);
+        wait until rising_edge(clk);
+        assert irq = '0'
+            report "irq high after IRQ_TX_IDLE was acknowledged" severity error;
+        axi_check(IRQ_STATUS_REG, x"00000003", x"00000000", "IRQ_TX_IDLE pending after its acknowledge");
+
+        -- The power source is set when ON_OFF_STATUS settles, driven after the edge like the controller
+        wait until rising_edge(clk);
+        on_off_status <= "01";
+        for i in 1 to 10 loop
+            wait until rising_edge(clk);
+        end loop;
+        assert irq_status(0) = '0'
+            report "IRQ_POWER set while turning on" severity error;
+        on_off_status <= "11";
+        for i in 1 to 5 loop
+            wait until rising_edge(clk);
+        end loop;
+        axi_check(IRQ_STATUS_REG, x"00000003", x"00000001", "IRQ_POWER not pending once ON");
+        assert irq = '0'
+            report "irq high for the disabled IRQ_POWER" severity error;
+        axi_write(IRQ_STATUS_REG, x"00000001");
+        axi_write(IRQ_ENABLE_REG, x"00000000");
+
+        -- Fill the queue while the first entry is being sent, one write dropped
+        axi_write(BURST_CTRL, x"00000010");
+        for i in 0 to FIFO_DEPTH + 1 loop
+            axi_write(SPI_BURST, x"000000C" & std_logic_vector(to_unsigned(i, 4)));
+        end loop;
+        wait until rising_edge(clk);
+        wait until rising_edge(clk);
+        axi_check(SPI_STATUS, x"00000018", x"00000018", "FIFO_FULL and FIFO_OVERFLOW not set after the dropped write");
+
+        -- FIFO_OVERFLOW is kept by a 0 and cleared by a 1
+        axi_write(SPI_STATUS, x"00000000");
+        axi_check(SPI_STATUS, x"00000010", x"00000010", "FIFO_OVERFLOW cleared by writing 0");
+        axi_write(SPI_STATUS, x"00000010");
+        axi_check(SPI_STATUS, x"00000010", x"00000000", "FIFO_OVERFLOW not cleared by writing 1");
+        wait_tx_idle;
+
+        wait for 100*clk_period;
+        assert received = EXPECTED'length
+            report "Received " & integer'image(received) & " bytes instead of " & integer'image(EXPECTED'length) severity error;
+        report "screen_slave_tb finished, " & integer'image(received) & " bytes checked" severity note;
+
+        done <= true;
+        wait;
+    end process;
+
+end Behavioral;
@@ -0,0 +1,338 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Self-checking: beats of the AXI-Stream port go through the stream sink and the TX queue, and
+-- must come out on MOSI byte 0 first with D/C high, with TKEEP trimming the last beat. The queue
+-- fills up during the frame, so the stream is held back by TREADY, and a write of the AXI slave
+-- in the same cycle as a beat must be pushed first without losing the beat. A null beat (TKEEP
+-- "0000") must be taken without pushing a byte.
+entity screen_stream_sink_tb is
+    Generic (
+        SPI_2X_CLK_DIV : positive := 2 -- Faster SCK than the IP to keep the simulation short
+    );
+    -- Port ( );
+end screen_stream_sink_tb;
+
+architecture Behavioral of screen_stream_sink_tb is
+
+    -- Component Under Test
+    component screen_stream_sink is
+        Port (
+            -- AXI-Stream slave, same clock as the queue
+            S_AXIS_TDATA  : in  std_logic_vector(31 downto 0);
+            S_AXIS_TKEEP  : in  std_logic_vector(3 downto 0);
+            S_AXIS_TLAST  : in  std_logic;
+            S_AXIS_TVALID : in  std_logic;
+            S_AXIS_TREADY : out std_logic;
+
+            -- Pushes of the AXI slave
+            TX_PUSH  : in std_logic;
+            TX_DATA  : in std_logic_vector(31 downto 0);
+            TX_DC    : in std_logic_vector(3 downto 0);
+            TX_COUNT : in std_logic_vector(1 downto 0);
+
+            -- TX queue push interface
+            FIFO_FULL  : in  std_logic;
+            PUSH       : out std_logic;
+            PUSH_DATA  : out std_logic_vector(31 downto 0);
+            PUSH_DC    : out std_logic_vector(3 downto 0);
+            PUSH_COUNT : out std_logic_vector(1 downto 0)
+        );
+    end component;
+
+    -- Clock
+    constant clk_period : time := 8 ns;
+
+    -- Expected bytes on the SPI bus
+    type tx_byte is record
+        byte : std_logic_vector(7 downto 0);
+        dc   : std_logic;
+    end record;
+    type tx_sequence is array(natural range <>) of tx_byte;
+
+    constant EXPECTED : tx_sequence := (
+        -- Command byte through SPI_CTRL before the frame
+        (x"15", '0'),
+        -- Frame of 6 beats, more than the queue holds, in memory order
+        (x"00", '1'), (x"01", '1'), (x"02", '1'), (x"03", '1'),
+        (x"04", '1'), (x"05", '1'), (x"06", '1'), (x"07", '1'),
+        (x"08", '1'), (x"09", '1'), (x"0A", '1'), (x"0B", '1'),
+        (x"0C", '1'), (x"0D", '1'), (x"0E", '1'), (x"0F", '1'),
+        (x"10", '1'), (x"11", '1'), (x"12", '1'), (x"13", '1'),
+        -- Last beat with TKEEP "0011"
+        (x"14", '1'), (x"15", '1'),
+        -- Write of the AXI slave and a beat (TKEEP "0111") in the same cycle
+        (x"5C", '0'),
+        (x"A0", '1'), (x"A1", '1'), (x"A2", '1')
+    );
+
+    -- Signals
+    signal clk    : std_logic := '0';
+    signal resetn : std_logic := '0';
+    signal done   : boolean := false;
+
+    signal tdata  : std_logic_vector(31 downto 0) := (others => '0');
+    signal tkeep  : std_logic_vector(3 downto 0) := (others => '0');
+    signal tlast  : std_logic := '0';
+    signal tvalid : std_logic := '0';
+    signal tready : std_logic := '0';
+
+    signal tx_push  : std_logic := '0';
+    signal tx_data  : std_logic_vector(31 downto 0) := (others => '0');
+    signal tx_dc    : std_logic_vector(3 downto 0) := (others => '0');
+    signal tx_count : std_logic_vector(1 downto 0) := (others => '0');
+
+    signal fifo_full  : std_logic := '0';
+    signal fifo_overflow : std_logic := '0';
+    signal push       : std_logic := '0';
+    signal push_data  : std_logic_vector(31 downto 0) := (others => '0');
+    signal push_dc    : std_logic_vector(3 downto 0) := (others => '0');
+    signal push_count : std_logic_vector(1 downto 0) := (others => '0');
+
+    signal tx_idle     : std_logic := '0';
+    signal spi_ready   : std_logic := '0';
+    signal spi_trigger : std_logic := '0';
+    signal byte        : std_logic_vector(7 downto 0) := (others => '0');
+    signal dc_select   : std_logic := '0';
+
+    signal rst  : std_logic := '1';
+    signal mosi : std_logic := '0';
+    signal sck  : std_logic := '0';
+    signal cs   : std_logic := '1';
+
+    signal received : natural := 0;
+    signal stalls   : natural := 0;
+
+begin
+
+    -- Port Map
+    CUT : screen_stream_sink
+        Port Map (
+            -- AXI-Stream slave, same clock as the queue
+            S_AXIS_TDATA  => tdata,
+            S_AXIS_TKEEP  => tkeep,
+            S_AXIS_TLAST  => tlast,
+            S_AXIS_TVALID => tvalid,
+            S_AXIS_TREADY => tready,
+
+            -- Pushes of the AXI slave
+            TX_PUSH  => tx_push,
+            TX_DATA  => tx_data,
+            TX_DC    => tx_dc,
+            TX_COUNT => tx_count,
+
+            -- TX queue push interface
+            FIFO_FULL  => fifo_full,
+            PUSH       => push,
+            PUSH_DATA  => push_data,
+            PUSH_DC    => push_dc,
+            PUSH_COUNT => push_count
+        );
+
+    queue_inst: entity work.screen_tx_queue
+        Generic Map (
+            FIFO_DEPTH => 4
+        )
+        Port Map (
+            CLK    => clk,
+            RESETN => resetn,
+
+            PUSH       => push,
+            PUSH_DATA  => push_data,
+            PUSH_DC    => push_dc,
+            PUSH_COUNT => push_count,
+
+            FIFO_LEVEL => open,
+            FIFO_EMPTY => open,
+            FIFO_FULL  => fifo_full,
+            FIFO_OVERFLOW => fifo_overflow,
+            TX_IDLE    => tx_idle,
+
+            SPI_READY   => spi_ready,
+            SPI_TRIGGER => spi_trigger,
+            BYTE        => byte,
+            DC_SELECT   => dc_select
+        );
+
+    -- Same SPI master configuration as the screen_controller, which bypasses these signals when ON
+    spi_master_inst: entity work.spi_master
+        Generic Map (
+            N              => 8,
+            CPOL           => '1',
+            CPHA           => '1',
+            PREFETCH       => 2,
+            SPI_2X_CLK_DIV => SPI_2X_CLK_DIV
+        )
+        Port Map (
+            sclk_i => clk,
+            pclk_i => clk,
+            rst_i  => rst,
+            ---- serial interface ----
+            spi_ssel_o => cs,
+            spi_sck_o  => sck,
+            spi_mosi_o => mosi,
+            spi_miso_i => '0',
+            ---- parallel interface ----
+            di_req_o   => open,
+            di_i       => byte,
+            wren_i     => spi_trigger,
+            wr_ack_o   => open,
+            do_valid_o => open,
+            do_o       => open,
+            done_o     => spi_ready
+        );
+
+    rst <= not resetn;
+
+    clk_proc : process
+    begin
+        if (done) then
+            wait;
+        end if;
+        clk <= '0';
+        wait for clk_period/2;
+        clk <= '1';
+        wait for clk_period/2;
+    end process;
+
+    -- SPI receiver, bits sampled on the rising edge of SCK (CPOL = CPHA = '1')
+    monitor_proc : process
+        variable shift : std_logic_vector(7 downto 0);
+    begin
+        for i in EXPECTED'range loop
+            for b in 7 downto 0 loop
+                wait until rising_edge(sck) and cs = '0';
+                shift(b) := mosi;
+            end loop;
+            assert shift = EXPECTED(i).byte
+                report "Byte " & integer'image(i) & " out of order" severity error;
+            assert dc_select = EXPECTED(i).dc
+                report "D/C of byte " & integer'image(i) & " differs from the pushed one" severity error;
+            received <= i + 1;
+        end loop;
+        wait until rising_edge(sck) and cs = '0';
+        report "Byte sent after the expected ones" severity error;
+        wait;
+    end process;
+
+    -- TREADY must keep the stream out of the full queue
+    overflow_proc : process(clk)
+    begin
+        if (rising_edge(clk)) then
+            assert fifo_overflow = '0'
+                report "Push dropped by the full queue" severity error;
+        end if;
+    end process;
+
+    stim_proc : process
+
+        -- One write of the AXI slave
+        procedure push_byte (
+            constant data : in std_logic_vector(7 downto 0);
+            constant dc   : in std_logic
+        ) is
+        begin
+            tx_push  <= '1';
+            tx_data  <= x"000000" & data;
+            tx_dc    <= "000" & dc;
+            tx_count <= "00";
+            wait until rising_edge(clk);
+            tx_push  <= '0';
+        end procedure;
+
+        -- Beat held until TREADY, as an AXI DMA does
+        procedure wait_beat is
+        begin
+            loop
+                wait until rising_edge(clk);
+                exit when tready = '1';
+                stalls <= stalls + 1;
+            end loop;
+            tvalid <= '0';
+            tlast  <= '0';
+        end procedure;
+
+        procedure send_beat (
+            constant data : in std_logic_vector(31 downto 0);
+            constant keep : in std_logic_vector(3 downto 0);
+            constant last : in std_logic
+        ) is
+        begin
+            tvalid <= '1';
+            tdata  <= data;
+            tkeep  <= keep;
+            tlast  <= last;
+            wait_beat;
+        end procedure;
+
+        procedure wait_idle is
+        begin
+            wait until rising_edge(clk);
+            wait until rising_edge(clk);
+            if (tx_idle = '0') then
+                wait until tx_idle = '1';
+            end if;
+        end procedure;
+
+    begin
+        wait for 5*clk_period;
+            resetn <= '1';
+        wait for 20*clk_period;
+        wait until rising_edge(clk);
+
+        -- Command, then the frame streamed back to back
+        push_byte(x"15", '0');
+        send_beat(x"03020100", "1111", '0');
+        send_beat(x"07060504", "1111", '0');
+        send_beat(x"0B0A0908", "1111", '0');
+        send_beat(x"0F0E0D0C", "1111", '0');
+        send_beat(x"13121110", "1111", '0');
+        send_beat(x"00001514", "0011", '1');
+        wait_idle;
+
+        assert stalls > 0
+            report "The stream was never held back by a full queue" severity error;
+
+        -- Both sources in the same cycle, the AXI slave goes first
+        wait until rising_edge(clk);
+        tx_push  <= '1';
+        tx_data  <= x"0000005C";
+        tx_dc    <= "0000";
+        tx_count <= "00";
+        tvalid   <= '1';
+        tdata    <= x"00A2A1A0";
+        tkeep    <= "0111";
+        tlast    <= '1';
+        wait until rising_edge(clk);
+        assert tready = '0'
+            report "Beat taken in the same cycle as a write of the AXI slave" severity error;
+        tx_push  <= '0';
+        wait_beat;
+        wait_idle;
+
+        -- Null beat, taken and dropped
+        tvalid <= '1';
+        tdata  <= x"000000EE";
+        tkeep  <= "0000";
+        tlast  <= '1';
+        loop
+            wait until rising_edge(clk);
+            assert push = '0'
+                report "Null beat pushed to the queue" severity error;
+            exit when tready = '1';
+        end loop;
+        tvalid <= '0';
+        tlast  <= '0';
+        wait_idle;
+
+        wait for 100*clk_period;
+        assert received = EXPECTED'length
+            report "Received " & integer'image(received) & " bytes instead of " & integer'image(EXPECTED'length) severity error;
+        report "screen_stream_sink_tb finished, " & integer'image(received) & " bytes checked, " & integer'image(stalls) & " stalled cycles" severity note;
+
+        done <= true;
+        wait;
+    end process;
+
+end Behavioral;
@@ -0,0 +1,261 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Self-checking: the bytes shifted out on MOSI and the D/C line sampled on their last bit
+-- are compared with the pushed entries, and a push into the full queue must be dropped and reported
+entity screen_tx_queue_tb is
+    Generic (
+        FIFO_DEPTH     : positive := 4; -- Small so the full queue is reached quickly
+        SPI_2X_CLK_DIV : positive := 2  -- Faster SCK than the IP to keep the simulation short
+    );
+    -- Port ( );
+end screen_tx_queue_tb;
+
+architecture Behavioral of screen_tx_queue_tb is
+
+    -- Component Under Test
+    component screen_tx_queue is
+        Generic (
+            FIFO_DEPTH : positive := 16
+        );
+        Port (
+            -- Sync
+            CLK    : in std_logic;
+            RESETN : in std_logic;
+
+            -- Push interface (AXI slave)
+            PUSH       : in std_logic;
+            PUSH_DATA  : in std_logic_vector(31 downto 0);
+            PUSH_DC    : in std_logic_vector(3 downto 0);
+            PUSH_COUNT : in std_logic_vector(1 downto 0);
+
+            -- Queue status
+            FIFO_LEVEL : out std_logic_vector(15 downto 0);
+            FIFO_EMPTY : out std_logic;
+            FIFO_FULL  : out std_logic;
+            FIFO_OVERFLOW : out std_logic;
+            TX_IDLE    : out std_logic;
+
+            -- screen_controller interface
+            SPI_READY   : in  std_logic;
+            SPI_TRIGGER : out std_logic;
+            BYTE        : out std_logic_vector(7 downto 0);
+            DC_SELECT   : out std_logic
+        );
+    end component;
+
+    -- Clock
+    constant clk_period : time := 8 ns;
+
+    -- Expected bytes on the SPI bus
+    type tx_byte is record
+        byte : std_logic_vector(7 downto 0);
+        dc   : std_logic;
+    end record;
+    type tx_sequence is array(natural range <>) of tx_byte;
+
+    constant EXPECTED : tx_sequence := (
+        -- Single byte, as written to SPI_CTRL
+        (x"15", '0'),
+        -- Four data bytes, lowest lane first
+        (x"11", '1'), (x"22", '1'), (x"33", '1'), (x"44", '1'),
+        -- Three bytes with mixed D/C flags
+        (x"AA", '1'), (x"BB", '0'), (x"CC", '1'),
+        -- Entries pushed back to back until the queue is full, the last push (x"A5") is dropped
+        (x"A0", '1'), (x"A1", '1'), (x"A2", '1'), (x"A3", '1'), (x"A4", '1')
+    );
+
+    -- Signals
+    signal clk    : std_logic := '0';
+    signal resetn : std_logic := '0';
+    signal done   : boolean := false;
+
+    signal push       : std_logic := '0';
+    signal push_data  : std_logic_vector(31 downto 0) := (others => '0');
+    signal push_dc    : std_logic_vector(3 downto 0) := (others => '0');
+    signal push_count : std_logic_vector(1 downto 0) := (others => '0');
+
+    signal fifo_level : std_logic_vector(15 downto 0) := (others => '0');
+    signal fifo_empty : std_logic := '0';
+    signal fifo_full  : std_logic := '0';
+    signal fifo_overflow : std_logic := '0';
+    signal tx_idle    : std_logic := '0';
+
+    signal spi_ready   : std_logic := '0';
+    signal spi_trigger : std_logic := '0';
+    signal byte        : std_logic_vector(7 downto 0) := (others => '0');
+    signal dc_select   : std_logic := '0';
+
+    signal rst  : std_logic := '1';
+    signal mosi : std_logic := '0';
+    signal sck  : std_logic := '0';
+    signal cs   : std_logic := '1';
+
+    signal received  : natural := 0;
+    signal overflows : natural := 0;
+
+begin
+
+    -- Port Map
+    CUT : screen_tx_queue
+        Generic Map (
+            FIFO_DEPTH => FIFO_DEPTH
+        )
+        Port Map (
+            -- Sync
+            CLK    => clk,
+            RESETN => resetn,
+
+            -- Push interface (AXI slave)
+            PUSH       => push,
+            PUSH_DATA  => push_data,
+            PUSH_DC    => push_dc,
+            PUSH_COUNT => push_count,
+
+            -- Queue status
+            FIFO_LEVEL => fifo_level,
+            FIFO_EMPTY => fifo_empty,
+            FIFO_FULL  => fifo_full,
+            FIFO_OVERFLOW => fifo_overflow,
+            TX_IDLE    => tx_idle,
+
+            -- screen_controller interface
+            SPI_READY   => spi_ready,
+            SPI_TRIGGER => spi_trigger,
+            BYTE        => byte,
+            DC_SELECT   => dc_select
+        );
+
+    -- Same SPI master configuration as the screen_controller, which bypasses these signals when ON
+    spi_master_inst: entity work.spi_master
+        Generic Map (
+            N              => 8,
+            CPOL           => '1',
+            CPHA           => '1',
+            PREFETCH       => 2,
+            SPI_2X_CLK_DIV => SPI_2X_CLK_DIV
+        )
+        Port Map (
+            sclk_i => clk,
+            pclk_i => clk,
+            rst_i  => rst,
+            ---- serial interface ----
+            spi_ssel_o => cs,
+            spi_sck_o  => sck,
+            spi_mosi_o => mosi,
+            spi_miso_i => '0',
+            ---- parallel interface ----
+            di_req_o   => open,
+            di_i       => byte,
+            wren_i     => spi_trigger,
+            wr_ack_o   => open,
+            do_valid_o => open,
+            do_o       => open,
+            done_o     => spi_ready
+        );
+
+    rst <= not resetn;
+
+    clk_proc : process
+    begin
+        if (done) then
+            wait;
+        end if;
+        clk <= '0';
+        wait for clk_period/2;
+        clk <= '1';
+        wait for clk_period/2;
+    end process;
+
+    -- SPI receiver, bits sampled on the rising edge of SCK (CPOL = CPHA = '1')
+    monitor_proc : process
+        variable shift : std_logic_vector(7 downto 0);
+    begin
+        for i in EXPECTED'range loop
+            for b in 7 downto 0 loop
+                wait until rising_edge(sck) and cs = '0';
+                shift(b) := mosi;
+            end loop;
+            assert shift = EXPECTED(i).byte
+                report "Byte " & integer'image(i) & " differs from the pushed one" severity error;
+            assert dc_select = EXPECTED(i).dc
+                report "D/C of byte " & integer'image(i) & " differs from the pushed one" severity error;
+            received <= i + 1;
+        end loop;
+        wait;
+    end process;
+
+    -- Cycles with a dropped push
+    overflow_proc : process(clk)
+    begin
+        if (rising_edge(clk)) then
+            if (fifo_overflow = '1') then
+                overflows <= overflows + 1;
+            end if;
+        end if;
+    end process;
+
+    stim_proc : process
+
+        -- One entry per clock cycle, PUSH stays high across consecutive calls
+        procedure push_entry (
+            constant data  : in std_logic_vector(31 downto 0);
+            constant dc    : in std_logic_vector(3 downto 0);
+            constant count : in std_logic_vector(1 downto 0)
+        ) is
+        begin
+            push       <= '1';
+            push_data  <= data;
+            push_dc    <= dc;
+            push_count <= count;
+            wait until rising_edge(clk);
+        end procedure;
+
+        procedure wait_tx_idle is
+        begin
+            push <= '0';
+            wait until rising_edge(clk);
+            wait until rising_edge(clk);
+            if (tx_idle = '0') then
+                wait until tx_idle = '1';
+            end if;
+        end procedure;
+
+    begin
+        wait for 5*clk_period;
+            resetn <= '1';
+        wait for 20*clk_period;
+        wait until rising_edge(clk);
+
+        assert fifo_empty = '1' and tx_idle = '1'
+            report "Queue not idle after reset" severity error;
+
+        -- Single byte, four byte burst and three byte burst
+        push_entry(x"00000015", "0000", "00");
+        push_entry(x"44332211", "1111", "11");
+        push_entry(x"00CCBBAA", "0101", "10");
+        wait_tx_idle;
+
+        -- Fill the queue while the first entry is being sent
+        for i in 0 to FIFO_DEPTH + 1 loop
+            push_entry(x"000000A" & std_logic_vector(to_unsigned(i, 4)), "0001", "00");
+        end loop;
+        push <= '0';
+        wait until rising_edge(clk);
+        assert fifo_full = '1'
+            report "Queue not full after " & integer'image(FIFO_DEPTH + 2) & " back to back pushes" severity error;
+        assert overflows = 1
+            report integer'image(overflows) & " pushes reported dropped instead of 1" severity error;
+        wait_tx_idle;
+
+        wait for 100*clk_period;
+        assert received = EXPECTED'length
+            report "Received " & integer'image(received) & " bytes instead of " & integer'image(EXPECTED'length) severity error;
+        report "screen_tx_queue_tb finished, " & integer'image(received) & " bytes checked" severity note;
+
+        done <= true;
+        wait;
+    end process;
+
+end Behavioral;
@@ -0,0 +1,159 @@
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+-- Self-checking: one byte is sent with each SCK divider written to clk_div_i, and the SCK
+-- period and the bits shifted out on MOSI are compared with the divider and the written byte.
+-- clk_div_i starts uninitialized and each divider is set while the count is above it.
+entity spi_clk_div_tb is
+    Generic (
+        SPI_2X_CLK_DIV : positive := 10 -- Same as the IP, used while clk_div_i is 0
+    );
+    -- Port ( );
+end spi_clk_div_tb;
+
+architecture Behavioral of spi_clk_div_tb is
+
+    -- Clock
+    constant clk_period : time := 8 ns;
+
+    -- Bytes and the divider they are sent with
+    type tx_byte is record
+        div  : natural; -- clk_div_i, 0 selects SPI_2X_CLK_DIV
+        byte : std_logic_vector(7 downto 0);
+    end record;
+    type tx_sequence is array(natural range <>) of tx_byte;
+
+    constant SEQUENCE : tx_sequence := (
+        (0,  x"A5"), -- Generic divider after reset, 6.25MHz SCK
+        (4,  x"3C"), -- 15.6MHz SCK
+        (2,  x"F0"), -- 31.25MHz SCK, fastest the driver allows
+        (16, x"0F"), -- Slower than the generic
+        (0,  x"81")  -- Back to the generic
+    );
+
+    function sck_period (div : natural) return time is
+    begin
+        if (div = 0) then
+            return 2 * SPI_2X_CLK_DIV * clk_period;
+        end if;
+        return 2 * div * clk_period;
+    end function;
+
+    -- Signals
+    signal clk  : std_logic := '0';
+    signal rst  : std_logic := '1';
+    signal done : boolean := false;
+
+    signal clk_div  : std_logic_vector(7 downto 0); -- Uninitialized until set, as SPI_CLK_DIV_SEL before the AXI reset
+    signal wren     : std_logic := '0';
+    signal di       : std_logic_vector(7 downto 0) := (others => '0');
+    signal spi_done : std_logic := '0';
+
+    signal mosi : std_logic := '0';
+    signal sck  : std_logic := '0';
+    signal cs   : std_logic := '1';
+
+    signal received : natural := 0;
+
+begin
+
+    -- Same SPI master configuration as the screen_controller
+    CUT: entity work.spi_master
+        Generic Map (
+            N              => 8,
+            CPOL           => '1',
+            CPHA           => '1',
+            PREFETCH       => 2,
+            SPI_2X_CLK_DIV => SPI_2X_CLK_DIV
+        )
+        Port Map (
+            sclk_i    => clk,
+            pclk_i    => clk,
+            rst_i     => rst,
+            clk_div_i => clk_div,
+            ---- serial interface ----
+            spi_ssel_o => cs,
+            spi_sck_o  => sck,
+            spi_mosi_o => mosi,
+            spi_miso_i => '0',
+            ---- parallel interface ----
+            di_req_o   => open,
+            di_i       => di,
+            wren_i     => wren,
+            wr_ack_o   => open,
+            do_valid_o => open,
+            do_o       => open,
+            done_o     => spi_done
+        );
+
+    clk_proc : process
+    begin
+        if (done) then
+            wait;
+        end if;
+        clk <= '0';
+        wait for clk_period/2;
+        clk <= '1';
+        wait for clk_period/2;
+    end process;
+
+    -- SPI receiver, bits sampled on the rising edge of SCK (CPOL = CPHA = '1')
+    monitor_proc : process
+        variable shift : std_logic_vector(7 downto 0);
+        variable last  : time := 0 ns;
+    begin
+        for i in SEQUENCE'range loop
+            for b in 7 downto 0 loop
+                wait until rising_edge(sck) and cs = '0';
+                shift(b) := mosi;
+                if (b < 7) then
+                    assert now - last = sck_period(SEQUENCE(i).div)
+                        report "SCK period of byte " & integer'image(i) & " is " & time'image(now - last)
+                             & " instead of " & time'image(sck_period(SEQUENCE(i).div)) severity error;
+                end if;
+                last := now;
+            end loop;
+            assert shift = SEQUENCE(i).byte
+                report "Byte " & integer'image(i) & " differs from the written one" severity error;
+            received <= i + 1;
+        end loop;
+        wait;
+    end process;
+
+    stim_proc : process
+    begin
+        wait for 5*clk_period;
+            rst <= '0';
+        wait for 5*clk_period;
+
+        for i in SEQUENCE'range loop
+            -- Park the count above every divider of the sequence, so the new one ends the period at once
+            clk_div <= x"FF";
+            wait for 20*clk_period;
+            -- The divider only changes between bytes, the driver drains the TX queue first
+            clk_div <= std_logic_vector(to_unsigned(SEQUENCE(i).div, 8));
+            wait for 5*clk_period;
+            wait until rising_edge(clk);
+                wren <= '1';
+                di   <= SEQUENCE(i).byte;
+            wait until rising_edge(clk);
+                wren <= '0';
+            wait until received = i + 1 for 20 * sck_period(SEQUENCE(i).div);
+            assert received = i + 1
+                report "Byte " & integer'image(i) & " not received" severity error;
+            if (spi_done = '0') then
+                wait until spi_done = '1';
+            end if;
+        end loop;
+
+        wait for 100*clk_period;
+        assert received = SEQUENCE'length
+            report "Received " & integer'image(received) & " bytes instead of " & integer'image(SEQUENCE'length) severity error;
+        report "spi_clk_div_tb finished, " & integer'image(received) & " bytes checked" severity note;
+
+        done <= true;
+        wait;
+    end process;
+
+end Behavioral;
@@ -27,6 +27,7 @@ architecture Behavioral of spi_master_tb is
             sclk_i : in std_logic := 'X'; -- high-speed serial interface system clock
             pclk_i : in std_logic := 'X'; -- high-speed parallel interface system clock
             rst_i  : in std_logic := 'X'; -- reset core
+            clk_div_i : in std_logic_vector (7 downto 0) := (others => '0'); -- runtime SPI_2X_CLK_DIV, 0 selects the generic
             ---- serial interface ----
             spi_ssel_o : out std_logic;        -- spi bus slave select line
             spi_sck_o  : out std_logic;        -- spi bus sck
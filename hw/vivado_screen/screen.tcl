@@ -29,12 +29,21 @@
 #
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/screen_controller.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/screen_tester.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/screen_tx_queue.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/screen_stream_sink.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/screen_irq.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/spi_master.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/design/top.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/constraint/screen.xdc"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/spi_master_tb.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_tester_tb.vhd"
 #    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_controller_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_tx_queue_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/spi_clk_div_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_stream_sink_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_irq_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/vhdl/testbench/screen_slave_tb.vhd"
+#    "C:/AlbertoNavas/code/fpga/pmod-oled-rgb/hw/src/ip/screen_2_0/hdl/screen_slave_lite_v2_0_S00_AXI.vhd"
 #
 #*****************************************************************************************
 
@@ -44,12 +53,21 @@ proc checkRequiredFiles { origin_dir} {
   set files [list \
  "[file normalize "$origin_dir/../src/vhdl/design/screen_controller.vhd"]"\
  "[file normalize "$origin_dir/../src/vhdl/design/screen_tester.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/design/screen_tx_queue.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/design/screen_stream_sink.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/design/screen_irq.vhd"]"\
  "[file normalize "$origin_dir/../src/vhdl/design/spi_master.vhd"]"\
  "[file normalize "$origin_dir/../src/vhdl/design/top.vhd"]"\
  "[file normalize "$origin_dir/../src/constraint/screen.xdc"]"\
  "[file normalize "$origin_dir/../src/vhdl/testbench/spi_master_tb.vhd"]"\
  "[file normalize "$origin_dir/../src/vhdl/testbench/screen_tester_tb.vhd"]"\
  "[file normalize "$origin_dir/../src/vhdl/testbench/screen_controller_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/testbench/screen_tx_queue_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/testbench/spi_clk_div_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/testbench/screen_stream_sink_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/testbench/screen_irq_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/vhdl/testbench/screen_slave_tb.vhd"]"\
+ "[file normalize "$origin_dir/../src/ip/screen_2_0/hdl/screen_slave_lite_v2_0_S00_AXI.vhd"]"\
   ]
   foreach ifile $files {
     if { ![file isfile $ifile] } {
@@ -173,6 +191,9 @@ set obj [get_filesets sources_1]
 set files [list \
  [file normalize "${origin_dir}/../src/vhdl/design/screen_controller.vhd"] \
  [file normalize "${origin_dir}/../src/vhdl/design/screen_tester.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/design/screen_tx_queue.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/design/screen_stream_sink.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/design/screen_irq.vhd"] \
  [file normalize "${origin_dir}/../src/vhdl/design/spi_master.vhd"] \
  [file normalize "${origin_dir}/../src/vhdl/design/top.vhd"] \
 ]
@@ -189,6 +210,21 @@ set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
 set_property -name "file_type" -value "VHDL" -objects $file_obj
 
+set file "$origin_dir/../src/vhdl/design/screen_tx_queue.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/design/screen_stream_sink.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/design/screen_irq.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
 set file "$origin_dir/../src/vhdl/design/spi_master.vhd"
 set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets sources_1] [list "*$file"]]
@@ -240,6 +276,12 @@ set files [list \
  [file normalize "${origin_dir}/../src/vhdl/testbench/spi_master_tb.vhd"] \
  [file normalize "${origin_dir}/../src/vhdl/testbench/screen_tester_tb.vhd"] \
  [file normalize "${origin_dir}/../src/vhdl/testbench/screen_controller_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/testbench/screen_tx_queue_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/testbench/spi_clk_div_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/testbench/screen_stream_sink_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/testbench/screen_irq_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/vhdl/testbench/screen_slave_tb.vhd"] \
+ [file normalize "${origin_dir}/../src/ip/screen_2_0/hdl/screen_slave_lite_v2_0_S00_AXI.vhd"] \
 ]
 add_files -norecurse -fileset $obj $files
 
@@ -259,6 +301,36 @@ set file [file normalize $file]
 set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
 set_property -name "file_type" -value "VHDL" -objects $file_obj
 
+set file "$origin_dir/../src/vhdl/testbench/screen_tx_queue_tb.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/testbench/spi_clk_div_tb.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/testbench/screen_stream_sink_tb.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/testbench/screen_irq_tb.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/vhdl/testbench/screen_slave_tb.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
+set file "$origin_dir/../src/ip/screen_2_0/hdl/screen_slave_lite_v2_0_S00_AXI.vhd"
+set file [file normalize $file]
+set file_obj [get_files -of_objects [get_filesets sim_1] [list "*$file"]]
+set_property -name "file_type" -value "VHDL" -objects $file_obj
+
 
 # Set 'sim_1' fileset file properties for local files
 # None
@@ -0,0 +1,71 @@
+#include <iostream> // cout
+#include <fstream>  // ofstream
+#include <memory>   // unique_ptr
+#include <string>   // string
+
+#include "screen_constants.h"
+#include "screen_registers.h"
+#include "screen.h"
+#include "bench.h"
+
+static void printUsage(const char *name) {
+
+    std::cerr << "Usage: " << name << " [uio device] [--filter <name>] [--out <file.json>] [--dma <uio device>]" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+
+    std::string uio = "uio0";
+    std::string filter;
+    std::string outPath;
+    std::string dmaDevice;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--dma" && i + 1 < argc) {
+            dmaDevice = argv[++i];
+        } else if (!arg.starts_with("--")) {
+            uio = arg;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cerr << "Screen benchmark application running." << std::endl;
+
+    std::unique_ptr<Screen> screen;
+
+    try {
+        screen = std::make_unique<Screen>(uio);
+        if (!dmaDevice.empty()) {
+            screen->attachDma(dmaDevice);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error initializing screen: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Bench bench(*screen, filter);
+    bench.full();
+
+    json results = bench.results();
+    results["device"] = uio;
+
+    if (outPath.empty()) {
+        std::cout << results.dump(4) << std::endl;
+    } else {
+        std::ofstream file(outPath);
+        if (!file) {
+            std::cerr << "Failed to open output file: " << outPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        file << results.dump(4) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#include <iostream> // cout
+#include <memory>   // unique_ptr
+#include <string>   // string
+#include <chrono>   // time
+
+#include "screen_constants.h"
+#include "screen_registers.h"
+#include "screen_trace.h"
+#include "screen.h"
+
+static void printUsage(const char *name) {
+
+    std::cerr << "Usage: " << name << " <uio device> <trace file> [--max]" << std::endl;
+    std::cerr << "  --max  Replay at maximum speed instead of the recorded timing" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 3 || argc > 4) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string uio = argv[1];
+    const std::string path = argv[2];
+    screen::trace::ReplaySpeed speed = screen::trace::ReplaySpeed::Original;
+
+    if (argc == 4) {
+        if (std::string(argv[3]) != "--max") {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        speed = screen::trace::ReplaySpeed::Maximum;
+    }
+
+    std::cout << "Screen replay application running." << std::endl;
+
+    std::unique_ptr<Screen> screen;
+
+    try {
+        screen = std::make_unique<Screen>(uio);
+    } catch (const std::exception &e) {
+        std::cerr << "Error initializing screen: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    screen::trace::ReplayStats stats{};
+    if (!screen->replayTrace(path, speed, &stats)) {
+        return EXIT_FAILURE;
+    }
+
+    const double elapsedSec = std::chrono::duration<double>(stats.elapsed).count();
+    const double recordedSec = std::chrono::duration<double>(stats.recorded).count();
+
+    std::cout << "Bytes replayed:  " << stats.bytes << std::endl;
+    std::cout << "Recorded span:   " << recordedSec << " s" << std::endl;
+    std::cout << "Replay time:     " << elapsedSec << " s" << std::endl;
+    if (elapsedSec > 0) {
+        std::cout << "Throughput:      " << (stats.bytes / elapsedSec) << " bytes/s" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -23,6 +23,7 @@ int main() {
 
         std::signal(SIGINT,  signalHandler);
         std::signal(SIGTERM, signalHandler);
+        std::signal(SIGUSR1, signalHandler);
 
         Service service(AppPaths::CONFIG_PATH);
         g_service = &service;
@@ -40,9 +41,15 @@ int main() {
     }
 }
 
-static void signalHandler(int) {
+static void signalHandler(int signum) {
 
-    if (g_service) {
+    if (!g_service) {
+        return;
+    }
+
+    if (signum == SIGUSR1) {
+        g_service->requestMetricsDump();
+    } else {
         g_service->stop();
     }
 }
\ No newline at end of file
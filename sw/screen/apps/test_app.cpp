@@ -6,7 +6,7 @@
 #include "screen.h"
 #include "test.h"
 
-int main() {
+int main(int argc, char *argv[]) {
 
     std::cout << "Screen test application running." << std::endl;
 
@@ -16,6 +16,11 @@ int main() {
     try {
         screenA = std::make_unique<Screen>("uio0");
         screenB = std::make_unique<Screen>("uio1");
+
+        // Optional DMA of screen A: test_app <uio device of the DMA>
+        if (argc == 2) {
+            screenA->attachDma(argv[1]);
+        }
     } catch (const std::exception &e) {
         std::cerr << "Error initializing screens: " << e.what() << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,86 @@
+#ifndef ANALOG_CLOCK_H
+#define ANALOG_CLOCK_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <array>   // array
+
+#include "service_constants.h"
+
+namespace service::analog {
+
+    // sin(2 * pi * part / whole), evaluated at compile time
+    constexpr double sine(size_t part, size_t whole) {
+
+        constexpr double Pi = 3.14159265358979323846;
+
+        // Angle in [-pi, pi), then folded into [-pi / 2, pi / 2] where the series converges fast
+        double turn = static_cast<double>(part % whole) / whole;
+        if (turn >= 0.5) {
+            turn -= 1.0;
+        }
+        double x = 2.0 * Pi * turn;
+        if (x > Pi / 2) {
+            x = Pi - x;
+        } else if (x < -Pi / 2) {
+            x = -Pi - x;
+        }
+
+        double term = x;
+        double sum = x;
+        for (int k = 1; k < 12; k++) {
+            term *= -x * x / ((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // cos(2 * pi * part / whole)
+    constexpr double cosine(size_t part, size_t whole) {
+
+        return sine(4 * part + whole, 4 * whole);
+    }
+
+    constexpr int roundToInt(double value) {
+
+        return static_cast<int>((value < 0) ? value - 0.5 : value + 0.5);
+    }
+
+    // Segment from inner to outer pixels away from the center, step of steps clockwise from 12 o'clock
+    constexpr Line spoke(size_t step, size_t steps, uint8_t inner, uint8_t outer) {
+
+        const double s = sine(step, steps);
+        const double c = cosine(step, steps);
+
+        return {
+            static_cast<uint8_t>(AnalogClockCenterX + roundToInt(inner * s)),
+            static_cast<uint8_t>(AnalogClockCenterY - roundToInt(inner * c)),
+            static_cast<uint8_t>(AnalogClockCenterX + roundToInt(outer * s)),
+            static_cast<uint8_t>(AnalogClockCenterY - roundToInt(outer * c))
+        };
+    }
+
+    template <size_t Steps>
+    constexpr std::array<Line, Steps> makeSpokes(uint8_t inner, uint8_t outer) {
+
+        std::array<Line, Steps> spokes{};
+        for (size_t i = 0; i < Steps; i++) {
+            spokes[i] = spoke(i, Steps, inner, outer);
+        }
+        return spokes;
+    }
+
+    // Minute hand for each minute, hour hand for each minute of 12 hours
+    inline constexpr std::array<Line, 60>  MinuteHands = makeSpokes<60>(0, AnalogClockMinuteHandLength);
+    inline constexpr std::array<Line, 720> HourHands   = makeSpokes<720>(0, AnalogClockHourHandLength);
+
+    inline constexpr std::array<Line, 12> Ticks = makeSpokes<12>(AnalogClockTickInner, AnalogClockTickOuter);
+    // Seconds marker centers, at the end of each spoke
+    inline constexpr std::array<Line, 60> SecondMarks = makeSpokes<60>(0, AnalogClockSecondRadius);
+    inline constexpr std::array<Line, AnalogClockSweepSteps> SweepHands = makeSpokes<AnalogClockSweepSteps>(0, AnalogClockSecondHandLength);
+
+    static_assert(MinuteHands[15].x2 == AnalogClockCenterX + AnalogClockMinuteHandLength && MinuteHands[15].y2 == AnalogClockCenterY);
+    static_assert(HourHands[360].x2 == AnalogClockCenterX && HourHands[360].y2 == AnalogClockCenterY + AnalogClockHourHandLength);
+}
+
+#endif // ANALOG_CLOCK_H
@@ -0,0 +1,117 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdint>     // uint
+#include <string>      // string
+#include <vector>      // vector
+#include <utility>     // forward
+#include <functional>  // invoke
+#include <chrono>      // time
+
+#include <nlohmann/json.hpp>
+
+#include "screen.h"
+
+using json = nlohmann::json;
+
+namespace bench {
+
+    struct Result {
+
+        std::string name;
+        uint64_t iterations;
+        double wallSec;
+        double cpuSec;
+        uint64_t bytes;
+        double wireSec; // Emulated SPI time, only with the emulator backend
+    };
+
+    // Fixed iteration counts and seed, so runs are comparable across commits
+    constexpr uint32_t Seed = 0x5EED;
+
+    constexpr uint64_t FrameIterations  = 20;
+    constexpr uint64_t DelayIterations  = 10;
+    constexpr std::chrono::nanoseconds ShortSpiDelay = std::chrono::microseconds(2);
+    constexpr uint64_t EncodeIterations = 1000;
+    constexpr uint64_t StringIterations = 200;
+    constexpr uint64_t TextIterations   = 1000;
+    constexpr size_t   TextBytes        = 4096;
+    constexpr uint64_t GlyphIterations  = 1000;
+    constexpr uint64_t RasterIterations = 100000;
+    inline const std::string SmoothFont = "smooth10-4bpp.bdf"; // In the fonts of the assets
+    constexpr uint64_t LineIterations   = 1000;
+    constexpr uint64_t CircleIterations = 100;
+    constexpr uint64_t CanvasIterations = 1000;
+    constexpr uint64_t ImageIterations  = 10;
+    constexpr uint64_t ClearIterations  = 1000;
+    constexpr uint64_t CopyIterations   = 1000;
+    constexpr uint64_t SpriteIterations = 1000;
+    constexpr uint8_t  SpriteSize       = 8;
+}
+
+class Bench {
+
+    public:
+        // Constructor
+        Bench(Screen &screen, const std::string &filter = "");
+
+        // Benchmark routines
+        void full();
+        void fullFrameBitmap();
+        void waitPolicy();
+        void string();
+        void utf8();
+        void glyph();
+        void glyphRaster();
+        void line();
+        void circle();
+        void canvas();
+        void compositor();
+        void imageImport();
+        void clear();
+        void copy();
+
+        json results() const;
+
+    private:
+        Screen &m_screen;
+        std::string m_filter;
+        std::vector<bench::Result> m_results;
+
+        static double cpuTimeSec();
+        double wireTimeSec() const;
+
+        // Runs f once to warm up, then `iterations` times while measuring
+        template <typename F>
+        void measure(const std::string &name, uint64_t iterations, F&& f)
+        {
+            if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+                return;
+            }
+
+            std::invoke(f, 0);
+
+            const uint64_t bytesStart = m_screen.getBytesSent();
+            const double wireStart = wireTimeSec();
+            const double cpuStart = cpuTimeSec();
+            const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+            for (uint64_t i = 0; i < iterations; i++) {
+                std::invoke(f, i);
+            }
+
+            const std::chrono::steady_clock::time_point wallEnd = std::chrono::steady_clock::now();
+            const double cpuEnd = cpuTimeSec();
+
+            m_results.push_back({
+                name,
+                iterations,
+                std::chrono::duration<double>(wallEnd - wallStart).count(),
+                cpuEnd - cpuStart,
+                m_screen.getBytesSent() - bytesStart,
+                wireTimeSec() - wireStart
+            });
+        }
+};
+
+#endif // BENCH_H
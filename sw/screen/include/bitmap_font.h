@@ -0,0 +1,121 @@
+#ifndef BITMAP_FONT_H
+#define BITMAP_FONT_H
+
+#include <cstdint>       // uint
+#include <cstddef>       // size_t
+#include <string>        // string
+#include <string_view>   // string_view
+#include <vector>        // vector
+#include <array>         // array
+#include <unordered_map> // unordered_map
+
+#include "screen_constants.h"
+#include "glyph_masks.h"
+
+namespace screen::fonts {
+
+    // PSF2 header, little endian
+    constexpr uint32_t Psf2Magic           = 0x864AB572;
+    constexpr uint32_t Psf2HasUnicodeTable = 0x01;
+    constexpr uint8_t  Psf2UnicodeStart    = 0xFE; // Start of a multi-codepoint sequence
+    constexpr uint8_t  Psf2UnicodeEnd      = 0xFF; // End of the codepoints of a glyph
+
+    struct Psf2Header {
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t flags;
+        uint32_t length;   // Number of glyphs
+        uint32_t charSize; // Bytes per glyph
+        uint32_t height;
+        uint32_t width;
+    };
+
+    // Glyphs larger than the screen are rejected
+    constexpr uint32_t MaxGlyphWidth  = screen::Geometry::Columns;
+    constexpr uint32_t MaxGlyphHeight = screen::Geometry::Rows;
+
+    // Shown for codepoints missing from the font
+    constexpr uint32_t FallbackCodepoint = '?';
+
+    // Codepoints below this one are looked up without hashing
+    constexpr uint32_t DirectCodepoints = 128;
+    constexpr uint32_t NoGlyph = UINT32_MAX;
+
+    // Anti-aliased fonts keep up to 4 bits of coverage per pixel, deeper BDF fonts are reduced to it
+    constexpr uint8_t MaxBitsPerPixel = 4;
+}
+
+// 1, 2 or 4 bit font with proportional glyphs of a common height, loaded once and packed in an atlas.
+// Glyph rows are stored as (width * bitsPerPixel + 7) / 8 bytes with the leftmost pixel in the
+// least significant bits, so 1 bit fonts have the same layout as the built-in fonts.
+class BitmapFont {
+
+    public:
+        struct Glyph {
+
+            uint32_t offset;  // First byte in the atlas
+            uint8_t width;    // Pixels stored per row
+            uint8_t advance;  // Pixels to the next glyph origin
+        };
+
+        BitmapFont();
+
+        // Built-in fixed fonts, codepoints 0 to 255
+        static BitmapFont fromFont(const screen::Font &font);
+        // Same, converted once and shared
+        static const BitmapFont &builtin(const screen::Font &font);
+
+        // PSF2 (.psf, .psfu) or BDF (.bdf), chosen by extension
+        bool load(const std::string &path);
+        bool loadPsf2(const std::string &path);
+        bool loadBdf(const std::string &path);
+
+        bool empty() const;
+        uint8_t height() const;
+        size_t glyphCount() const;
+        // 1 for plain fonts, 2 or 4 for anti-aliased ones
+        uint8_t bitsPerPixel() const;
+        // Changes each time glyphs are loaded, copies of a font share it
+        uint64_t id() const;
+
+        // nullptr when the codepoint is not in the font
+        const Glyph *find(uint32_t codepoint) const;
+        // Falls back to '?' and then to the first glyph
+        const Glyph &glyphOrFallback(uint32_t codepoint) const;
+
+        const Glyph &glyph(uint32_t index) const;
+        // Index of the glyph drawn for codepoint, after the fallbacks
+        uint32_t glyphIndex(uint32_t codepoint) const;
+
+        // Glyph indices of a UTF-8 string, one per codepoint, missing ones replaced by the fallback
+        void shape(std::string_view text, std::vector<uint32_t> &run) const;
+
+        // Draws the glyph pixels over glyph.width columns of height() rows of stride pixels,
+        // leaving the pixels under unset bits untouched
+        void rasterise(const Glyph &glyph, screen::Color color, screen::Color *out, size_t stride) const;
+        // Same for any depth, each covered pixel is replaced by the ramp color of its coverage level
+        void rasterise(const Glyph &glyph, const screen::glyph::Ramp &ramp, screen::Color *out, size_t stride) const;
+
+    private:
+        uint8_t m_height = 0;
+        uint8_t m_bitsPerPixel = 1;
+        uint64_t m_id = 0;
+
+        std::vector<uint8_t> m_atlas;
+        std::vector<Glyph> m_glyphs;
+
+        std::array<uint32_t, screen::fonts::DirectCodepoints> m_direct{};
+        std::unordered_map<uint32_t, uint32_t> m_index;
+
+        void clear(uint8_t height, uint8_t bitsPerPixel);
+        uint32_t addGlyph(uint8_t width, uint8_t advance);
+        void setPixel(const Glyph &glyph, size_t row, size_t col);
+        void setLevel(const Glyph &glyph, size_t row, size_t col, uint8_t level);
+        void map(uint32_t codepoint, uint32_t glyphIndex);
+
+        size_t stride(uint8_t width) const;
+};
+
+#endif // BITMAP_FONT_H
@@ -0,0 +1,89 @@
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <span>    // span
+#include <vector>  // vector
+
+#include "screen_constants.h"
+
+namespace screen::canvas {
+
+    // Polygon vertex on pixel corners: {0, 0}, {4, 0}, {4, 4}, {0, 4} covers 4x4 pixels
+    struct Point {
+
+        int x;
+        int y;
+    };
+
+    // Pixels x1 to x2 of row y
+    struct Span {
+
+        uint8_t y;
+        uint8_t x1;
+        uint8_t x2;
+    };
+
+    // Arcs are drawn as polygons with a vertex every ArcStep pixels along the outer edge
+    constexpr float ArcStep = 2.0f;
+}
+
+// Software framebuffer drawn on the CPU and sent to a screen at once with Screen::drawCanvas.
+// Every shape is clipped to the canvas and filled as horizontal spans, one row at a time.
+// Rectangles and lines take inclusive pixel coordinates, like the Screen methods.
+class Canvas {
+
+    public:
+        explicit Canvas(uint8_t width = screen::Geometry::Columns, uint8_t height = screen::Geometry::Rows,
+                        screen::Color background = screen::StandardColor::Black);
+
+        uint8_t width() const;
+        uint8_t height() const;
+
+        // Row-major pixels, width() * height()
+        const std::vector<screen::Color> &pixels() const;
+        // Black outside the canvas
+        screen::Color pixel(int x, int y) const;
+
+        void clear(screen::Color color);
+
+        // Pixels x1 to x2 of row y
+        void fillSpan(int x1, int x2, int y, screen::Color color);
+        void setPixel(int x, int y, screen::Color color);
+
+        void drawLine(int x1, int y1, int x2, int y2, screen::Color color);
+        // Line with square ends, thickness pixels wide around the segment between the pixel centers
+        void drawThickLine(int x1, int y1, int x2, int y2, uint8_t thickness, screen::Color color);
+
+        void fillRect(int x1, int y1, int x2, int y2, screen::Color color);
+        void fillRoundedRect(int x1, int y1, int x2, int y2, uint8_t radius, screen::Color color);
+
+        // Centered on pixel (cx, cy), 2 * r + 1 pixels across
+        void fillCircle(int cx, int cy, int r, screen::Color color);
+        void fillEllipse(int cx, int cy, int rx, int ry, screen::Color color);
+        // Ring of thickness pixels inside radius r, from startDeg to endDeg clockwise from 12 o'clock
+        void drawArc(int cx, int cy, int r, uint8_t thickness, float startDeg, float endDeg, screen::Color color);
+
+        // Even-odd filled polygon
+        void fillPolygon(std::span<const screen::canvas::Point> points, screen::Color color);
+
+    private:
+        struct Vertex {
+
+            float x;
+            float y;
+        };
+
+        uint8_t m_width;
+        uint8_t m_height;
+        std::vector<screen::Color> m_pixels;
+
+        // Polygon being filled and its crossings with the current row
+        std::vector<Vertex> m_vertices;
+        std::vector<float> m_crossings;
+
+        void fillVertices(screen::Color color);
+};
+
+#endif // CANVAS_H
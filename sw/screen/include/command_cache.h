@@ -0,0 +1,45 @@
+#ifndef COMMAND_CACHE_H
+#define COMMAND_CACHE_H
+
+#include <cstdint>  // uint
+#include <array>    // array
+#include <optional> // optional
+#include <span>     // span
+
+#include "screen_constants.h"
+
+// Controller state last committed by the commands sent to it: address window, remap and color depth,
+// fill and reverse copy, scrolling setup and activation. A command that would leave it as it is needs
+// no bytes on the wire. The window only counts as unchanged while the RAM pointer is back at its start,
+// that is after whole windows of data, since setting the window is also what moves the pointer there.
+class CommandCache {
+
+    public:
+        // True when cmd with params would not change the controller
+        bool isRedundant(screen::Command cmd, std::span<const uint8_t> params) const;
+        // Records cmd as sent
+        void commit(screen::Command cmd, std::span<const uint8_t> params);
+        // Data bytes written to the display RAM, they move the RAM pointer through the window
+        void addData(uint64_t bytes);
+        // Nothing is known, e.g. after a power transition or bytes that may have been lost
+        void invalidate();
+
+    private:
+        std::optional<std::array<uint8_t, 2>> m_columns;
+        std::optional<std::array<uint8_t, 2>> m_rows;
+        std::optional<uint8_t> m_remap;
+        std::optional<uint8_t> m_fill;
+        std::optional<std::array<uint8_t, 5>> m_scrollSetup;
+        std::optional<bool> m_scrolling;
+
+        // Each axis of the RAM pointer at the start of the window, m_windowData bytes ago
+        bool m_columnAtStart = false;
+        bool m_rowAtStart = false;
+        uint64_t m_windowData = 0;
+
+        bool isPointerAtStart() const;
+        // Folds m_windowData into the axis flags before the window or the pixel size changes
+        void settlePointer();
+};
+
+#endif // COMMAND_CACHE_H
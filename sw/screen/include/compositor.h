@@ -0,0 +1,55 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <span>    // span
+#include <vector>  // vector
+
+#include "screen_constants.h"
+#include "canvas.h"
+
+namespace screen::compositor {
+
+    // Pixels of this color in layers above the first let the layers below show through
+    constexpr Color Transparent = {1, 0, 1};
+
+    // Unchanged pixels between two changed ones of a row are sent again when there are at most
+    // this many, which is cheaper than opening another window for the rest of the row
+    constexpr uint8_t MergeGap = 2;
+}
+
+// Stack of canvases composed on the CPU. Each compose returns the spans of pixels that differ
+// from the previous composite, so a screen only receives what changed since the last flush.
+// Layer 0 is opaque, the layers above it start transparent.
+class Compositor {
+
+    public:
+        Compositor(uint8_t width, uint8_t height, size_t layers, screen::Color background = screen::StandardColor::Black);
+
+        uint8_t width() const;
+        uint8_t height() const;
+        size_t layerCount() const;
+
+        Canvas &layer(size_t index);
+        // Background for layer 0, transparent for the others
+        void clearLayer(size_t index);
+
+        // Composes the layers and returns the changed spans, ordered by row then column
+        std::span<const screen::canvas::Span> compose();
+        const Canvas &composite() const;
+
+        // The next compose returns every pixel, for when the screen no longer shows the composite
+        void invalidate();
+
+    private:
+        screen::Color m_background;
+        std::vector<Canvas> m_layers;
+
+        Canvas m_composite; // Also what the last compose reported as shown
+        bool m_valid = false;
+
+        std::vector<screen::canvas::Span> m_damage;
+};
+
+#endif // COMPOSITOR_H
@@ -0,0 +1,103 @@
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <string>  // string
+#include <array>   // array
+#include <chrono>  // time
+
+#include "screen_constants.h"
+
+namespace screen::emulator {
+
+    // Entries of the TX queue reported in IP_INFO, writes into the full queue are dropped
+    constexpr uint32_t TxFifoDepth = 16;
+
+    // Each SPI_STATUS read stands for the time one entry takes on the wire, and FIFO_LEVEL misses
+    // the last writes posted before it, as on the IP
+    constexpr uint32_t TxFifoDrainPerRead = 1;
+    constexpr uint32_t TxFifoLevelLag = 3;
+
+    // Device names served by the emulator on the target build (e.g. "emu0")
+    constexpr const char *DevicePrefix = "emu";
+
+    // When set, the framebuffer is saved as <dir>/<device>.ppm when the emulator is destroyed
+    constexpr const char *DumpDirEnv = "SCREEN_EMU_DUMP_DIR";
+}
+
+// Software model of the screen IP registers and the SSD1331 controller behind them
+class Emulator {
+
+    public:
+        explicit Emulator(const std::string &device);
+        ~Emulator();
+
+        static bool isEmulated(const std::string &device);
+
+        // Register interface, same layout as the AXI slave
+        void writeRegister(size_t reg, uint32_t value);
+        uint32_t readRegister(size_t reg) const;
+
+        // Stream port of the IP, every byte is data and they are sent in order
+        void receiveStream(const uint8_t *data, size_t length);
+
+        // Display RAM as RGB565, indexed by row * Columns + column
+        const std::array<uint16_t, screen::Geometry::Pixels> &frame() const;
+
+        uint64_t bytesReceived() const;
+        std::chrono::nanoseconds wireTime() const;
+
+        bool savePpm(const std::string &path) const;
+
+    private:
+        std::string m_device;
+
+        uint32_t m_powerCtrl = 0;
+        uint32_t m_burstCtrl = 0;
+        uint32_t m_clockDivider = 0; // SPI_CLK_DIV, 0 for SpecClockDivider
+        uint32_t m_irqEnable = 0;
+        uint32_t m_irqStatus = 0;    // Pending sources, there is no line to raise
+        mutable uint32_t m_txLevel = 0;  // Entries waiting in the TX queue, drained by status reads
+        mutable uint32_t m_txPosted = 0; // Writes since the last status read
+        bool m_txOverflow = false;       // FIFO_OVERFLOW
+        uint64_t m_bytes = 0;
+        uint64_t m_wireNs = 0;
+
+        std::array<uint16_t, screen::Geometry::Pixels> m_frame{};
+
+        // Command parser
+        uint8_t m_command = 0;
+        uint8_t m_paramsExpected = 0;
+        uint8_t m_paramsReceived = 0;
+        std::array<uint8_t, 32> m_params{};
+
+        // Controller state
+        screen::ColumnRowAddr m_window = screen::defaultColumnRowAddr;
+        uint8_t m_column = 0;
+        uint8_t m_row = 0;
+        uint8_t m_remap = screen::defaultRemapColorDepth;
+        bool m_fill = screen::defaultFillRectangle;
+        bool m_reverseCopy = screen::defaultReverseCopy;
+
+        // Pixel assembly
+        std::array<uint8_t, 3> m_pixelBytes{};
+        uint8_t m_pixelBytesReceived = 0;
+
+        bool pushTxEntry();
+        void receiveByte(uint8_t byte, screen::DataMode mode);
+        void receiveCommandByte(uint8_t byte);
+        void receiveDataByte(uint8_t byte);
+        void executeCommand();
+
+        void writePixel(uint16_t color);
+        void setPixel(int column, int row, uint16_t color);
+        void drawLine(int c1, int r1, int c2, int r2, uint16_t color);
+        void drawRectangle(int c1, int r1, int c2, int r2, uint16_t line, uint16_t fill);
+        void copy(int c1, int r1, int c2, int r2, int c3, int r3);
+
+        static uint8_t paramCount(uint8_t command);
+        static uint16_t colorFromParams(const uint8_t *params);
+};
+
+#endif // EMULATOR_H
@@ -0,0 +1,102 @@
+#ifndef FRAME_DMA_H
+#define FRAME_DMA_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <string>  // string
+#include <vector>  // vector
+#include <chrono>  // time
+
+#include "emulator.h"
+
+namespace screen::dma {
+
+    // AXI DMA registers of the MM2S channel in simple mode (32 bit words)
+    constexpr size_t MM2S_DMACR  = 0x00 / 4;
+    constexpr size_t MM2S_DMASR  = 0x04 / 4;
+    constexpr size_t MM2S_SA     = 0x18 / 4;
+    constexpr size_t MM2S_LENGTH = 0x28 / 4;
+
+    // MM2S_DMACR
+    constexpr uint32_t DMACR_RS         = 1u << 0;
+    constexpr uint32_t DMACR_RESET      = 1u << 2;
+    constexpr uint32_t DMACR_IOC_IRQ_EN = 1u << 12;
+    constexpr uint32_t DMACR_ERR_IRQ_EN = 1u << 14;
+
+    // MM2S_DMASR
+    constexpr uint32_t DMASR_HALTED  = 1u << 0;
+    constexpr uint32_t DMASR_IDLE    = 1u << 1;
+    constexpr uint32_t DMASR_ERRORS  = 0x7u << 4; // DMAIntErr, DMASlvErr, DMADecErr
+    constexpr uint32_t DMASR_IOC_IRQ = 1u << 12;
+    constexpr uint32_t DMASR_ERR_IRQ = 1u << 14;
+
+    // Register window of the AXI DMA
+    constexpr size_t MapSize = 0x10000;
+
+    // Shorter bulk data goes through the registers of the IP, the DMA setup would take longer
+    constexpr size_t MinTransferBytes = 1024;
+
+    // A 65k color frame takes 16 ms at the default SCK, a transfer is given up long after
+    constexpr std::chrono::milliseconds TransferTimeout{500};
+    // Status polls while waiting without an interrupt
+    constexpr std::chrono::microseconds PollInterval{100};
+    // Soft reset of the channel, a few clock cycles in practice
+    constexpr uint32_t ResetPolls = 1000;
+
+    // The frame buffer is the second memory map of the UIO device of the DMA, a reserved-memory region of the device tree
+    constexpr size_t BufferMap = 1;
+    // Attributes of the UIO memory maps (addr, size)
+    constexpr const char *UioSysfsDir = "/sys/class/uio/";
+
+    // Emulated DMAs copy from an ordinary buffer of this size
+    constexpr size_t EmulatedBufferBytes = 16 * 1024;
+}
+
+// Frames sent from a physically contiguous buffer (reserved memory, map 1 of the UIO device) to the stream port of the
+// screen IP by an AXI DMA (MM2S, simple mode) mapped through UIO, so the CPU only writes the buffer and starts the transfer.
+// An emulated DMA (device named "emuN") hands the buffer to the emulator of the screen instead.
+class FrameDma {
+
+    public:
+        // Throws when the devices cannot be opened or mapped, or when an emulated DMA has no emulator
+        FrameDma(const std::string &dma_device, Emulator *emulator = nullptr);
+        ~FrameDma();
+
+        FrameDma(const FrameDma &) = delete;
+        FrameDma &operator=(const FrameDma &) = delete;
+
+        // Bytes of the next transfer are written here, not before wait() returned for the previous one
+        uint8_t *buffer();
+        size_t capacity() const;
+
+        // Starts sending the first length bytes of the buffer, false when they do not fit or the channel halted
+        bool start(size_t length);
+        // Returns once the buffer has been read, false on a DMA error or timeout (the channel is then reset)
+        bool wait(std::chrono::milliseconds timeout = screen::dma::TransferTimeout);
+        bool isBusy() const;
+
+        // True when the UIO device of the DMA delivers its interrupt, never when emulated
+        bool hasInterrupt() const;
+
+    private:
+        int m_fd = -1;
+        volatile uint32_t *m_reg = nullptr;
+        uint8_t *m_buffer = nullptr;
+        size_t m_size = 0;
+        uint32_t m_physAddr = 0;
+        bool m_interrupt = false;
+        bool m_busy = false;
+
+        Emulator *m_emulator = nullptr;
+        std::vector<uint8_t> m_emulatedBuffer;
+
+        void writeRegister(size_t reg, uint32_t value);
+        uint32_t readRegister(size_t reg) const;
+        bool reset();
+        bool enableInterrupt();
+        void release();
+
+        static uint64_t readBufferAttribute(const std::string &dma_device, const std::string &attribute);
+};
+
+#endif // FRAME_DMA_H
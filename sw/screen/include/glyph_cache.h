@@ -0,0 +1,54 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <cstdint>       // uint
+#include <cstddef>       // size_t
+#include <span>          // span
+#include <vector>        // vector
+#include <unordered_map> // unordered_map
+
+#include "screen_constants.h"
+#include "bitmap_font.h"
+
+namespace screen::glyph {
+
+    // Encoded glyphs kept per Screen, the cache is emptied when a new glyph would not fit
+    constexpr size_t CacheCapacityBytes = 64 * 1024;
+}
+
+// Glyphs blended over their background and encoded in the wire format of a color depth,
+// so drawing a known glyph is a copy of its rows whatever the depth of the font.
+class GlyphCache {
+
+    public:
+        // Encoded rows of glyph.width pixels, hit is false when the glyph had to be encoded
+        std::span<const uint8_t> get(const BitmapFont &font, uint32_t index, screen::Color color, screen::Color background,
+                                     screen::RemapColorDepth::ColorDepth depth, bool &hit);
+
+        void clear();
+        size_t sizeBytes() const;
+
+    private:
+        struct Key {
+
+            uint64_t font;   // BitmapFont::id
+            uint64_t colors; // Color and background, one byte per channel
+            uint32_t glyph;
+            uint8_t depth;
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct KeyHash {
+
+            size_t operator()(const Key &key) const;
+        };
+
+        std::unordered_map<Key, std::vector<uint8_t>, KeyHash> m_glyphs;
+        size_t m_bytes = 0;
+
+        // Pixels of the glyph being encoded
+        std::vector<screen::Color> m_pixels;
+};
+
+#endif // GLYPH_CACHE_H
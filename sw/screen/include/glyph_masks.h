@@ -0,0 +1,81 @@
+#ifndef GLYPH_MASKS_H
+#define GLYPH_MASKS_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <array>   // array
+
+#include "screen_constants.h"
+
+// Expansion of 1 bit font rows into per pixel masks, generated at compile time
+namespace screen::glyph {
+
+    // Pixels of a font row byte, the LSB is the leftmost column
+    constexpr size_t RowPixels = 8;
+
+    using RowMask = std::array<uint8_t, RowPixels>;
+
+    // rowMask[byte][col] is 0xFF when the pixel is on and 0x00 when it is off
+    constexpr std::array<RowMask, 256> makeRowMasks() {
+
+        std::array<RowMask, 256> masks{};
+        for (size_t byte = 0; byte < masks.size(); byte++) {
+            for (size_t col = 0; col < RowPixels; col++) {
+                masks[byte][col] = (byte & (1u << col)) ? 0xFF : 0x00;
+            }
+        }
+        return masks;
+    }
+
+    inline constexpr std::array<RowMask, 256> RowMasks = makeRowMasks();
+
+    static_assert(RowMasks[0x01][0] == 0xFF && RowMasks[0x01][1] == 0x00);
+    static_assert(RowMasks[0x80][7] == 0xFF && RowMasks[0x80][6] == 0x00);
+
+    // Foreground where the mask is set, black elsewhere
+    constexpr Color blend(Color color, uint8_t mask) {
+
+        return {
+            static_cast<uint8_t>(color.r & mask),
+            static_cast<uint8_t>(color.g & mask),
+            static_cast<uint8_t>(color.b & mask)
+        };
+    }
+
+    // Foreground where the mask is set, background elsewhere
+    constexpr Color blend(Color color, Color background, uint8_t mask) {
+
+        return {
+            static_cast<uint8_t>((color.r & mask) | (background.r & ~mask)),
+            static_cast<uint8_t>((color.g & mask) | (background.g & ~mask)),
+            static_cast<uint8_t>((color.b & mask) | (background.b & ~mask))
+        };
+    }
+
+    // Coverage levels of anti-aliased glyphs, 0 is the background and 15 the foreground
+    constexpr size_t RampLevels = 16;
+
+    using Ramp = std::array<Color, RampLevels>;
+
+    // Colors from background to foreground for one (color, background) pair, so blending
+    // an anti-aliased pixel is a lookup. Channels are interpolated in their 565 range.
+    constexpr Ramp makeRamp(Color color, Color background) {
+
+        constexpr unsigned last = RampLevels - 1;
+
+        Ramp ramp{};
+        for (unsigned level = 0; level < RampLevels; level++) {
+            auto mix = [level](uint8_t fg, uint8_t bg) {
+                return static_cast<uint8_t>((fg * level + bg * (last - level) + last / 2) / last);
+            };
+            ramp[level] = {mix(color.r, background.r), mix(color.g, background.g), mix(color.b, background.b)};
+        }
+        return ramp;
+    }
+
+    static_assert(makeRamp(StandardColor::White, StandardColor::Black)[0].g == 0);
+    static_assert(makeRamp(StandardColor::White, StandardColor::Black)[15].g == ColorLimit::G_565_MAX);
+    static_assert(makeRamp(StandardColor::White, StandardColor::Black)[5].r == 10);
+}
+
+#endif // GLYPH_MASKS_H
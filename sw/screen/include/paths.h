@@ -1,11 +1,19 @@
 #ifndef PATHS_H
 #define PATHS_H
 
+#include <string> // string
+
+// Overridden by host builds to use the assets of the source tree
+#ifndef SCREEN_BASE_DIR
+#define SCREEN_BASE_DIR "/opt/screen/"
+#endif
+
 namespace AppPaths {
-    const std::string BASE_DIR   = "/opt/screen/";
+    const std::string BASE_DIR   = SCREEN_BASE_DIR;
     const std::string ASSETS_DIR = BASE_DIR + "assets/";
     const std::string CONFIG_PATH = ASSETS_DIR + "config.json";
     const std::string IMAGES_DIR  = ASSETS_DIR + "images/";
+    const std::string FONTS_DIR   = ASSETS_DIR + "fonts/";
 }
 
 #endif // PATHS_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef PIXEL_ENCODING_H
+#define PIXEL_ENCODING_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+
+#include "screen_constants.h"
+
+// Wire format of a pixel for each color depth of the SSD1331.
+// Each encoding is a compile time parameter, so loops over a bitmap are specialised per depth.
+namespace screen::encoding {
+
+    // 1 byte: RRRGGGBB
+    struct Color256 {
+
+        static constexpr RemapColorDepth::ColorDepth Depth = RemapColorDepth::ColorDepth::Color256;
+        static constexpr size_t Bytes = 1;
+
+        static constexpr void pack(Color color, uint8_t *out) {
+            out[0] = static_cast<uint8_t>((color.r >> 2) << 5 | (color.g >> 3) << 2 | (color.b >> 3));
+        }
+    };
+
+    // 2 bytes: RRRRRGGG GGGBBBBB
+    struct Color65k {
+
+        static constexpr RemapColorDepth::ColorDepth Depth = RemapColorDepth::ColorDepth::Color65k;
+        static constexpr size_t Bytes = 2;
+
+        static constexpr void pack(Color color, uint8_t *out) {
+            const uint16_t data = static_cast<uint16_t>(color.r << 11 | color.g << 5 | color.b);
+            out[0] = static_cast<uint8_t>(data >> 8);
+            out[1] = static_cast<uint8_t>(data);
+        }
+    };
+
+    // 3 bytes: RRRRR0 GGGGGG BBBBB0 (6 bit channels)
+    struct Color65kAlt {
+
+        static constexpr RemapColorDepth::ColorDepth Depth = RemapColorDepth::ColorDepth::Color65kAlt;
+        static constexpr size_t Bytes = 3;
+
+        static constexpr void pack(Color color, uint8_t *out) {
+            out[0] = static_cast<uint8_t>(color.r << 1);
+            out[1] = color.g;
+            out[2] = static_cast<uint8_t>(color.b << 1);
+        }
+    };
+
+    // Largest pixel of any encoding
+    constexpr size_t MaxBytes = Color65kAlt::Bytes;
+
+    // Encodes count pixels into out, which must hold count * Encoding::Bytes bytes
+    template <typename Encoding>
+    constexpr void packPixels(const Color *colors, size_t count, uint8_t *out) {
+
+        for (size_t i = 0; i < count; i++) {
+            Encoding::pack(colors[i], out + i * Encoding::Bytes);
+        }
+    }
+
+    template <typename Encoding>
+    constexpr bool packsTo(Color color, uint8_t b0, uint8_t b1 = 0, uint8_t b2 = 0) {
+
+        uint8_t out[MaxBytes] = {0};
+        Encoding::pack(color, out);
+        return out[0] == b0 && out[1] == b1 && out[2] == b2;
+    }
+
+    static_assert(packsTo<Color256>(StandardColor::White, 0xFF));
+    static_assert(packsTo<Color256>(StandardColor::Red, 0xE0));
+    static_assert(packsTo<Color65k>(StandardColor::White, 0xFF, 0xFF));
+    static_assert(packsTo<Color65k>(StandardColor::Green, 0x07, 0xE0));
+    static_assert(packsTo<Color65kAlt>(StandardColor::White, 0x3E, 0x3F, 0x3E));
+    static_assert(packsTo<Color65kAlt>(StandardColor::Blue, 0x00, 0x00, 0x3E));
+}
+
+#endif // PIXEL_ENCODING_H
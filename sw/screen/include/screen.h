@@ -7,13 +7,23 @@
 #include <vector>      // vector
 #include <chrono>      // time
 #include <string_view> // string_view
+#include <memory>      // unique_ptr
 
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "screen_trace.h"
+#include "screen_metrics.h"
+#include "emulator.h"
+#include "frame_dma.h"
+#include "bitmap_font.h"
+#include "glyph_cache.h"
+#include "command_cache.h"
+#include "canvas.h"
 
 class Screen {
 
     friend class Test;
+    friend class Bench;
 
     public:
         //// Constructor and Destructor
@@ -35,9 +45,19 @@ class Screen {
         bool copyWindow(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t c3, uint8_t r3);
 
         bool drawImage(const std::string &path);
+        // Whole canvas in one window with its top left corner at (x, y)
+        bool drawCanvas(const Canvas &canvas, uint8_t x = 0, uint8_t y = 0);
+        // Only the spans of the canvas, spans with the same columns on consecutive rows share a window
+        bool drawCanvas(const Canvas &canvas, std::span<const screen::canvas::Span> spans, uint8_t x = 0, uint8_t y = 0);
 
         bool drawSymbol(const uint8_t symbol, uint8_t x, uint8_t y, const screen::Font &font, screen::Color color);
         bool drawString(std::string_view phrase, uint8_t x, uint8_t y, const screen::Font &font, screen::Color color);
+        // Anti-aliased fonts are blended over background
+        bool drawString(std::string_view phrase, uint8_t x, uint8_t y, const BitmapFont &font, screen::Color color, screen::Color background = screen::StandardColor::Black);
+        // Glyph indices of font drawn from offset inside a line window of width pixels, the rest of the window is background
+        bool drawGlyphRun(std::span<const uint32_t> run, uint8_t x, uint8_t y, uint8_t width, uint8_t offset, const BitmapFont &font, screen::Color color, screen::Color background = screen::StandardColor::Black);
+        // Same line, but only the columns [begin, end) of the window are sent
+        bool drawGlyphRun(std::span<const uint32_t> run, uint8_t x, uint8_t y, uint8_t width, uint8_t offset, const BitmapFont &font, screen::Color color, screen::Color background, uint8_t begin, uint8_t end);
 
         bool setupScrolling(uint8_t horizontalScrollOffset, uint8_t startRow, uint8_t rowsNumber, uint8_t verticalScrollOffset, uint8_t timeInterval);
         void enableScrolling(bool value);
@@ -46,6 +66,35 @@ class Screen {
         void setSpiDelay(std::chrono::nanoseconds delay);
         std::chrono::nanoseconds getSpiDelay() const;
 
+        void setWaitPolicy(screen::wait::Policy policy);
+        screen::wait::Policy getWaitPolicy() const;
+        // True when the UIO device delivers interrupts, never with the emulator
+        bool hasInterrupt() const;
+        // True when the IP raises its interrupt at the end of power transitions and when the TX queue runs idle
+        bool hasInterruptSources() const;
+        screen::wait::Calibration getWaitCalibration() const;
+
+        // Entries of the TX queue of the IP, 0 when the IP has none
+        uint32_t getTxFifoDepth() const;
+        // Disabled, every byte goes through SPI_CTRL as with IPs without the queue
+        void setTxFifoEnable(bool enable);
+        bool getTxFifoEnable() const;
+        // Bitmaps of at least MinTransferBytes are sent by the AXI DMA in front of the stream port of the IP, from the
+        // buffer of its UIO device, while the CPU goes on. Throws when the device cannot be opened
+        void attachDma(const std::string &dma_device);
+        // True when a DMA is attached and the IP has the stream port
+        bool hasDma() const;
+        // Disabled, bitmaps go through the registers as without a DMA
+        void setDmaEnable(bool enable);
+        bool getDmaEnable() const;
+        // Disabled, every configuration command is sent even when the controller already holds its values
+        void setCommandCacheEnable(bool enable);
+        bool getCommandCacheEnable() const;
+
+        // SCK divider of the IP (SCK = 125 MHz / (2 * divider)), 0 when the IP has a fixed one
+        bool setSpiClockDivider(uint32_t divider);
+        uint32_t getSpiClockDivider() const;
+
         void setScreenOrientation(const screen::Orientation orientation);
         screen::Orientation getScreenOrientation() const;
 
@@ -54,12 +103,44 @@ class Screen {
 
         void applyDefaultSettings();
 
+        //// SPI trace
+        bool startTrace(const std::string &path, size_t capacity = screen::trace::defaultCapacity);
+        void stopTrace();
+        bool isTracing() const;
+        bool replayTrace(const std::string &path, screen::trace::ReplaySpeed speed, screen::trace::ReplayStats *stats = nullptr);
+
+        //// Metrics
+        screen::metrics::Snapshot getMetrics() const;
+        uint64_t getBytesSent() const;
+        void resetMetrics();
+
+        // Software backend, nullptr when driving a real device
+        const Emulator *getEmulator() const;
+
     private:
-        int m_fd;
+        int m_fd = -1;
         volatile uint32_t *m_reg = nullptr;
+        std::unique_ptr<Emulator> m_emulator;
         static constexpr uint64_t MAP_SIZE = 0x10000;
 
         std::chrono::nanoseconds m_spiDelay = screen::defaultSpiDelay;
+        screen::wait::Policy m_waitPolicy = screen::wait::defaultPolicy;
+        bool m_interrupt = false;
+        bool m_interruptSources = false; // IRQ_ENABLE and IRQ_STATUS
+        screen::wait::Calibration m_calibration{};
+        uint64_t m_byteDelayLoops = 0; // Delay loop iterations covering DelayPercent of a byte
+        bool m_bulkTransfer = false;   // Set while sending data long enough for the delay loop
+        uint32_t m_txFifoDepth = 0;
+        bool m_txFifoEnable = true;
+        uint32_t m_burstControl = 0;   // Last value written to SPI_BURST_CTRL
+        bool m_stream = false;
+        std::unique_ptr<FrameDma> m_dma;
+        bool m_dmaEnable = true;
+        bool m_dmaBusy = false;        // A transfer may still be feeding the TX queue
+        CommandCache m_commandCache;
+        bool m_commandCacheEnable = true;
+        uint32_t m_spiClockDivider = 0;
+        uint32_t m_spiClockDividerDefault = 0; // Divider of the IP after reset
         screen::Orientation m_orientation = screen::defaultOrientation;
         bool m_fillRectangle = screen::defaultFillRectangle;
         bool m_reverseCopy = screen::defaultReverseCopy;
@@ -67,6 +148,32 @@ class Screen {
         screen::ColumnRowAddr m_columnRowAddr = screen::defaultColumnRowAddr;
         uint8_t m_remapColorDepthCfg = screen::defaultRemapColorDepth;
 
+        // SPI trace ring file (mapped), nullptr when not tracing
+        int m_traceFd = -1;
+        screen::trace::Header *m_trace = nullptr;
+        screen::trace::Record *m_traceRecords = nullptr;
+        size_t m_traceMapSize = 0;
+        uint64_t m_traceLastNs = 0;
+
+        // Per method and per command counters
+        screen::metrics::Counters m_metrics;
+
+        // Encoded pixels of the last bitmap or text line, reused to avoid an allocation per bitmap
+        std::vector<uint8_t> m_pixelBuffer;
+
+        // Glyphs already blended and encoded, copied as is into text lines
+        GlyphCache m_glyphCache;
+
+        // Codepoints or glyph indices and pixels of the last string
+        std::vector<uint32_t> m_textRun;
+        std::vector<screen::Color> m_textLine;
+
+        // Pixels of the canvas window being sent
+        std::vector<screen::Color> m_canvasWindow;
+
+        // Command and parameters posted to the TX queue together
+        std::vector<uint8_t> m_commandBytes;
+
         // Helper for byte manipulation
         static constexpr void setField(uint8_t &reg, uint8_t mask, uint8_t pos, uint8_t value) {
             reg = (reg & ~mask) | ((value << pos) & mask);
@@ -84,6 +191,10 @@ class Screen {
         // SPI Communication
         bool isSpiReady() const;
         bool isSpiDataRequest() const;
+        void waitForSpiReady();
+        void waitDelay(std::chrono::nanoseconds delay);
+        void delayLoops(uint64_t loops) const;
+        void calibrateWaits();
         void sendSpiByte(uint8_t byte, screen::DataMode mode);
         void sendCommand(screen::Command cmd, std::span<const uint8_t> params);
         inline void sendCommand(screen::Command cmd) {
@@ -98,9 +209,34 @@ class Screen {
         void sendData(const uint8_t data);
         void sendMultiData(const uint8_t *data, size_t length);
 
+        // TX queue, bytes posted in SPI_BURST writes without waiting for each one
+        uint32_t detectTxFifo();
+        void detectSpiClockDivider();
+        bool useTxFifo() const;
+        uint32_t waitForTxFifoSpace();
+        uint32_t readTxFifoLevel();
+        void postBytes(const uint8_t *data, size_t length, screen::DataMode mode);
+
+        // Stream port, fed by the DMA from its buffer while the registers are left alone
+        bool useDma(size_t length) const;
+        bool startDma(size_t length);
+        void finishDma();
+
+        // UIO interrupt, masked by the kernel after each one until it is enabled again
+        bool enableInterrupt();
+        bool waitForInterrupt(std::chrono::milliseconds timeout);
+        // Sources of the IP that raise the interrupt, pending events are dropped
+        void armInterrupt(uint32_t sources);
+        void disarmInterrupt();
+
+        // SPI trace
+        void recordTrace(uint8_t byte, screen::DataMode mode);
+
         //// Utilities
         void sendPixel(const screen::Color color);
         void sendMultiPixel(const std::vector<screen::Color> &colors);
+        template <typename Encoding>
+        void sendMultiPixelAs(const std::vector<screen::Color> &colors);
 
         ////  Internal settings
         void setColumnRowAddr(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2);
@@ -116,12 +252,22 @@ class Screen {
         void setColorDepth(screen::RemapColorDepth::ColorDepth depth);
         void applyRemapColorDepth(screen::ApplyMode mode = screen::ApplyMode::Current);
         uint8_t getRemapColorDepth() const;
+        screen::RemapColorDepth::ColorDepth getColorDepth() const;
 
         //// Helpers
         bool waitForPowerState(screen::PowerState target, std::chrono::milliseconds timeout);
         std::vector<screen::Color> importImageAsBitmap(const std::string &path);
         std::vector<screen::Color> importSymbolAsBitmap(const uint8_t symbol, const screen::Font &font, screen::Color color);
-        uint32_t utf8_decode(const uint8_t *s, size_t *len);
+        uint8_t textLineLimit() const;
+        void rasteriseRun(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background);
+        bool drawTextLine(uint8_t x, uint8_t y, size_t width, uint8_t height);
+        // Encoded text lines, in m_pixelBuffer
+        size_t composeRun(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background);
+        template <typename Encoding>
+        void composeRunAs(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background);
+        void cropTextLine(size_t width, uint8_t height, size_t begin, size_t end, size_t bytesPerPixel);
+        bool sendTextLine(uint8_t x, uint8_t y, size_t width, uint8_t height);
+        void drawOutlineRuns(uint8_t x, uint8_t y, uint8_t size, std::vector<uint8_t> &outline, screen::Color color);
 };
 
 #endif // SCREEN_H
\ No newline at end of file
@@ -61,10 +61,68 @@ namespace screen {
         ContinuousScrolling   = 0x27,
         DeactivateScroll      = 0x2E,
         ActivateScroll        = 0x2F,
+        Nop                   = 0xE3,
     };
 
     constexpr std::chrono::nanoseconds defaultSpiDelay = std::chrono::nanoseconds(0);
 
+    namespace wait {
+
+        // Spin: poll the status registers until they change.
+        // Yield: poll, giving the CPU away between reads.
+        // Hybrid: poll for SpinBudget, then sleep on the UIO interrupt when the device has one.
+        // Adaptive: like Hybrid, but long transfers wait out each byte in a calibrated delay loop
+        // before reading the status, short SPI delays are busy-waited on the clock and stalls
+        // without an interrupt back off to yield.
+        enum class Policy : uint8_t {
+
+            Spin,
+            Yield,
+            Hybrid,
+            Adaptive
+        };
+
+        constexpr Policy defaultPolicy = Policy::Adaptive;
+
+        // Far longer than a byte on the wire, so only stalled transfers block
+        constexpr std::chrono::nanoseconds SpinBudget = std::chrono::microseconds(20);
+
+        // Longest sleep without reading the status again, not every IP raises the interrupt
+        constexpr std::chrono::milliseconds BlockSlice = std::chrono::milliseconds(5);
+
+        // Transfers expected to take longer than this use the delay loop between bytes
+        constexpr std::chrono::nanoseconds BulkThreshold = std::chrono::microseconds(50);
+
+        // Shorter SPI delays are busy-waited, sleeping rounds them up to tens of microseconds
+        constexpr std::chrono::nanoseconds SleepThreshold = std::chrono::microseconds(100);
+
+        // The delay loop covers this share of a byte, the status is polled for the rest
+        constexpr uint32_t DelayPercent = 75;
+
+        constexpr uint32_t CalibrationBytes = 32;     // Nop commands timed at startup
+        constexpr uint32_t CalibrationLoops = 100000; // Delay loop iterations timed at startup
+
+        // Measured when the screen is opened
+        struct Calibration {
+
+            std::chrono::nanoseconds byteTime; // Register write to SPI_READY of one byte
+            double loopsPerNs;                 // Delay loop iterations per nanosecond
+        };
+    }
+
+    namespace spi {
+
+        // Clock of the IP, SCK = ClockHz / (2 * divider)
+        constexpr uint32_t ClockHz = 125000000;
+
+        // 31.25 MHz, the SPI master glitches with CPHA = 1 below this divider
+        constexpr uint32_t MinClockDivider = 2;
+        constexpr uint32_t MaxClockDivider = 255;
+
+        // 6.25 MHz, the SSD1331 serial clock cycle is 150 ns minimum so faster dividers are out of spec
+        constexpr uint32_t SpecClockDivider = 10;
+    }
+
     namespace Geometry {
 
         constexpr uint8_t Rows    = 64;
@@ -0,0 +1,175 @@
+#ifndef SCREEN_METRICS_H
+#define SCREEN_METRICS_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <array>   // array
+#include <atomic>  // atomic
+#include <chrono>  // time
+#include <bit>     // bit_width
+
+namespace screen::metrics {
+
+    // Public Screen methods with their own counters
+    enum class Method : uint8_t {
+
+        SetOnOff,
+        ClearWindow,
+        DrawBitmap,
+        DrawLine,
+        DrawRectangle,
+        DrawCircle,
+        CopyWindow,
+        DrawImage,
+        DrawSymbol,
+        DrawString,
+        DrawGlyphRun,
+        DrawCanvas,
+        SetupScrolling,
+        EnableScrolling,
+        SetScreenOrientation,
+        SetFillRectangleEnable,
+        SetReverseCopyEnable,
+        ApplyDefaultSettings,
+        Count
+    };
+
+    constexpr size_t MethodCount  = static_cast<size_t>(Method::Count);
+    constexpr size_t CommandCount = 256; // Indexed by screen::Command opcode
+
+    // Bucket i counts samples in [2^(i-1), 2^i) ns, bucket 0 counts 0 ns
+    constexpr size_t HistogramBuckets = 32;
+
+    // Counters are written by the thread that owns the Screen and may be read from any thread.
+    // Relaxed ordering is enough: each counter is independent and only needs to be tear-free.
+    struct Stat {
+
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::array<std::atomic<uint64_t>, HistogramBuckets> latency{};
+    };
+
+    struct Counters {
+
+        std::atomic<uint64_t> commandBytes{0};
+        std::atomic<uint64_t> dataBytes{0};
+        std::atomic<uint64_t> busyNs{0}; // Time spent inside outermost public methods
+        std::atomic<uint64_t> glyphCacheHits{0};
+        std::atomic<uint64_t> glyphCacheMisses{0};
+        std::atomic<uint64_t> interruptWakeups{0}; // Sleeps on the UIO interrupt ended by the interrupt
+        std::atomic<uint64_t> interruptTimeouts{0}; // or by the end of the slice
+        std::atomic<uint64_t> txFifoWrites{0}; // SPI_BURST writes posted to the TX queue
+        std::atomic<uint64_t> txFifoFull{0};   // Times the TX queue was found full
+        std::atomic<uint64_t> txFifoOverflows{0}; // Times the IP reported writes dropped by the full queue
+        std::atomic<uint64_t> dmaTransfers{0}; // Bitmaps sent by the DMA through the stream port
+        std::atomic<uint64_t> dmaErrors{0};    // Transfers that failed to start or to finish
+        std::atomic<uint64_t> suppressedCommands{0};     // Commands the controller already held, not sent
+        std::atomic<uint64_t> suppressedCommandBytes{0}; // and their bytes
+
+        std::array<Stat, MethodCount> methods{};
+        std::array<Stat, CommandCount> commands{};
+
+        uint32_t depth = 0; // Nesting of public methods, owner thread only
+    };
+
+    struct StatSnapshot {
+
+        uint64_t calls;
+        uint64_t bytes;
+        uint64_t totalNs;
+        std::array<uint64_t, HistogramBuckets> latency;
+
+        // Latency estimate for quantile q in [0, 1], interpolated inside the log2 bucket
+        uint64_t percentileNs(double q) const;
+    };
+
+    struct Snapshot {
+
+        uint64_t commandBytes;
+        uint64_t dataBytes;
+        uint64_t busyNs;
+        uint64_t glyphCacheHits;
+        uint64_t glyphCacheMisses;
+        uint64_t interruptWakeups;
+        uint64_t interruptTimeouts;
+        uint64_t txFifoWrites;
+        uint64_t txFifoFull;
+        uint64_t txFifoOverflows;
+        uint64_t dmaTransfers;
+        uint64_t dmaErrors;
+        uint64_t suppressedCommands;
+        uint64_t suppressedCommandBytes;
+
+        std::array<StatSnapshot, MethodCount> methods;
+        std::array<StatSnapshot, CommandCount> commands;
+    };
+
+    inline uint64_t nowNs() {
+
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline void add(std::atomic<uint64_t> &counter, uint64_t value) {
+
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    inline size_t bucketOf(uint64_t ns) {
+
+        const size_t b = static_cast<size_t>(std::bit_width(ns));
+        return (b < HistogramBuckets) ? b : HistogramBuckets - 1;
+    }
+
+    inline void record(Stat &stat, uint64_t ns, uint64_t bytes) {
+
+        add(stat.calls, 1);
+        add(stat.bytes, bytes);
+        add(stat.totalNs, ns);
+        add(stat.latency[bucketOf(ns)], 1);
+    }
+
+    inline uint64_t totalBytes(const Counters &c) {
+
+        return c.commandBytes.load(std::memory_order_relaxed) + c.dataBytes.load(std::memory_order_relaxed);
+    }
+
+    // Records latency and wire bytes of a public method for the lifetime of the object
+    class Scope {
+
+        public:
+            Scope(Counters &counters, Method method)
+                : m_counters(counters), m_method(method), m_startNs(nowNs()), m_startBytes(totalBytes(counters)) {
+                m_counters.depth++;
+            }
+
+            ~Scope() {
+                const uint64_t ns = nowNs() - m_startNs;
+                record(m_counters.methods[static_cast<size_t>(m_method)], ns, totalBytes(m_counters) - m_startBytes);
+                if (--m_counters.depth == 0) {
+                    add(m_counters.busyNs, ns);
+                }
+            }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            Counters &m_counters;
+            Method m_method;
+            uint64_t m_startNs;
+            uint64_t m_startBytes;
+    };
+
+    StatSnapshot snapshot(const Stat &stat);
+    Snapshot snapshot(const Counters &counters);
+    // What was recorded between the snapshots before and after, e.g. over one export window
+    StatSnapshot delta(const StatSnapshot &after, const StatSnapshot &before);
+    void reset(Counters &counters);
+
+    const char *methodName(Method method);
+    const char *commandName(uint8_t opcode);
+}
+
+#endif // SCREEN_METRICS_H
@@ -7,6 +7,12 @@ namespace screen::reg {
     constexpr uint32_t POWER_STATUS = 1; // slv_reg1
     constexpr uint32_t SPI_CTRL     = 2; // slv_reg2
     constexpr uint32_t SPI_STATUS   = 3; // slv_reg3
+    constexpr uint32_t SPI_BURST      = 4; // slv_reg4
+    constexpr uint32_t SPI_BURST_CTRL = 5; // slv_reg5
+    constexpr uint32_t IP_INFO        = 6; // slv_reg6
+    constexpr uint32_t SPI_CLK_DIV    = 7; // slv_reg7
+    constexpr uint32_t IRQ_ENABLE     = 10; // slv_reg10
+    constexpr uint32_t IRQ_STATUS     = 11; // slv_reg11, write 1 to clear
 }
 
 namespace screen::bit {
@@ -25,6 +31,27 @@ namespace screen::bit {
     // slv_reg3
     constexpr uint32_t SPI_READY        = 0;
     constexpr uint32_t SPI_DATA_REQUEST = 1;
+    constexpr uint32_t FIFO_EMPTY       = 2;
+    constexpr uint32_t FIFO_FULL        = 3;
+    constexpr uint32_t FIFO_OVERFLOW    = 4;
+    constexpr uint32_t FIFO_LEVEL       = 16; // bits [31:16]
+
+    // slv_reg5
+    constexpr uint32_t BURST_COUNT = 0; // bits [1:0]
+    constexpr uint32_t BURST_DC    = 4; // bits [7:4]
+
+    // slv_reg6
+    constexpr uint32_t FIFO_DEPTH = 0; // bits [15:0]
+    constexpr uint32_t STREAM     = 17;
+    constexpr uint32_t IRQ        = 18;
+
+    // slv_reg7
+    constexpr uint32_t CLK_DIV         = 0; // bits [7:0]
+    constexpr uint32_t CLK_DIV_DEFAULT = 8; // bits [15:8]
+
+    // slv_reg10, slv_reg11
+    constexpr uint32_t IRQ_POWER   = 0;
+    constexpr uint32_t IRQ_TX_IDLE = 1;
 }
 
 namespace screen::mask {
@@ -43,7 +70,38 @@ namespace screen::mask {
     // slv_reg3
     constexpr uint32_t SPI_READY        = 1u << bit::SPI_READY;
     constexpr uint32_t SPI_DATA_REQUEST = 1u << bit::SPI_DATA_REQUEST;
+    constexpr uint32_t FIFO_EMPTY       = 1u << bit::FIFO_EMPTY;
+    constexpr uint32_t FIFO_FULL        = 1u << bit::FIFO_FULL;
+    constexpr uint32_t FIFO_OVERFLOW    = 1u << bit::FIFO_OVERFLOW;
+    constexpr uint32_t FIFO_LEVEL       = 0xFFFFu << bit::FIFO_LEVEL;
+
+    // slv_reg5
+    constexpr uint32_t BURST_COUNT = 0b11 << bit::BURST_COUNT;
+    constexpr uint32_t BURST_DC    = 0xF  << bit::BURST_DC;
+
+    // slv_reg6
+    constexpr uint32_t FIFO_DEPTH = 0xFFFFu << bit::FIFO_DEPTH;
+    constexpr uint32_t STREAM     = 1u      << bit::STREAM;
+    constexpr uint32_t IRQ        = 1u      << bit::IRQ;
+
+    // slv_reg7
+    constexpr uint32_t CLK_DIV         = 0xFF << bit::CLK_DIV;
+    constexpr uint32_t CLK_DIV_DEFAULT = 0xFF << bit::CLK_DIV_DEFAULT;
+
+    // slv_reg10, slv_reg11
+    constexpr uint32_t IRQ_POWER   = 1u << bit::IRQ_POWER;
+    constexpr uint32_t IRQ_TX_IDLE = 1u << bit::IRQ_TX_IDLE;
+    constexpr uint32_t IRQ_SOURCES = IRQ_POWER | IRQ_TX_IDLE;
+}
+
+namespace screen::burst {
 
+    // Bytes of one SPI_BURST write
+    constexpr uint32_t MaxBytes = 4;
+
+    // Free slots of the TX queue left unused: FIFO_LEVEL counts a write up to 3 cycles after it,
+    // and the status read can overtake writes still posted in the interconnect
+    constexpr uint32_t FifoReserve = 4;
 }
 
 //  -- SCREEN IP REGISTER MAP --
@@ -62,15 +120,54 @@ namespace screen::mask {
 
 // 	-- Slave Register 2 (slv_reg2) (WRITE)
 // 		-- Bits 31:10 : Reserved
-// 		-- Bit 9      : SPI_TRIGGER (W) Control signal to trigger sending the BYTE to the screen via SPI
+// 		-- Bit 9      : SPI_TRIGGER (W) Control signal to push the BYTE to the TX queue
 // 		-- Bit 8      : DC_SELECT (W) Control signal to select Data/Command for the BYTE to send
-// 			-- 0: Data
-// 			-- 1: Command
+// 			-- 0: Command
+// 			-- 1: Data
 // 		-- Bits 7:0   : BYTE (W) Byte to send to the screen via SPI
 
-// 	-- Slave Register 3 (slv_reg3) (READ)
-// 		-- Bits 31:2  : Reserved
+// 	-- Slave Register 3 (slv_reg3) (READ/WRITE 1 TO CLEAR)
+// 		-- Bits 31:16 : FIFO_LEVEL (R) Entries waiting in the TX queue
+// 		-- Bits 15:5  : Reserved
+// 		-- Bit 4      : FIFO_OVERFLOW (R/W1C) A SPI_CTRL or SPI_BURST write found the TX queue full and was dropped
+// 		-- Bit 3      : FIFO_FULL (R) The TX queue is full, further SPI_CTRL and SPI_BURST writes are dropped
+// 		-- Bit 2      : FIFO_EMPTY (R) The TX queue is empty
 // 		-- Bit 1      : SPI_DATA_REQUEST (R) Status signal to indicate that the screen_controller is ready to receive a new BYTE to send via SPI
-// 		-- Bit 0      : SPI_READY (R) Status signal to indicate that the screen_controller has finished sending the previous BYTE via SPI
+// 		-- Bit 0      : SPI_READY (R) Status signal to indicate that the TX queue is empty and the screen_controller has finished sending the last BYTE via SPI
+
+// 	-- Slave Register 4 (slv_reg4) (WRITE)
+// 		-- Bits 31:0  : SPI_BURST (W) Up to 4 bytes pushed to the TX queue as one entry, bits 7:0 are sent first
+
+// 	-- Slave Register 5 (slv_reg5) (READ/WRITE)
+// 		-- Bits 31:8  : Reserved
+// 		-- Bits 7:4   : BURST_DC (RW) DC_SELECT of each byte of SPI_BURST, bit 4 for bits 7:0
+// 		-- Bits 3:2   : Reserved
+// 		-- Bits 1:0   : BURST_COUNT (RW) Bytes of SPI_BURST to send minus one
+
+// 	-- Slave Register 6 (slv_reg6) (READ)
+// 		-- Bits 31:19 : Reserved
+// 		-- Bit 18     : IRQ (R) IRQ_ENABLE and IRQ_STATUS are available
+// 		-- Bit 17     : STREAM (R) S00_AXIS beats are sent as data bytes, byte 0 first
+// 		-- Bit 16     : Reserved
+// 		-- Bits 15:0  : FIFO_DEPTH (R) Entries the TX queue can hold
+// 		-- IPs without the TX queue read FIFO_EMPTY as 0, the driver then writes SPI_CTRL only
+
+// 	-- Slave Register 7 (slv_reg7) (READ/WRITE)
+// 		-- Bits 31:16 : Reserved
+// 		-- Bits 15:8  : SPI_CLK_DIV_DEFAULT (R) SCK divider used while SPI_CLK_DIV is 0
+// 		-- Bits 7:0   : SPI_CLK_DIV (RW) SCK divider, SCK = 125 MHz / (2 * SPI_CLK_DIV)
+// 			-- 0: SPI_CLK_DIV_DEFAULT
+// 		-- IPs without the register read SPI_CLK_DIV_DEFAULT as 0, the divider is then fixed
+
+// 	-- Slave Register 10 (slv_reg10) (READ/WRITE)
+// 		-- Bits 31:2  : Reserved
+// 		-- Bit 1      : IRQ_TX_IDLE (RW) Raise irq when the TX queue runs idle
+// 		-- Bit 0      : IRQ_POWER (RW) Raise irq when ON_OFF_STATUS settles in OFF or ON
+
+// 	-- Slave Register 11 (slv_reg11) (READ/WRITE 1 TO CLEAR)
+// 		-- Bits 31:2  : Reserved
+// 		-- Bit 1      : IRQ_TX_IDLE (R/W1C) The TX queue has run idle since the last acknowledge
+// 		-- Bit 0      : IRQ_POWER (R/W1C) A power transition has ended since the last acknowledge
+// 		-- irq is high while a pending bit is enabled, pending bits are set whether enabled or not
 
 #endif // SCREEN_REGISTERS_H
\ No newline at end of file
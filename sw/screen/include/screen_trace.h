@@ -0,0 +1,53 @@
+#ifndef SCREEN_TRACE_H
+#define SCREEN_TRACE_H
+
+#include <cstdint> // uint
+#include <cstddef> // size_t
+#include <chrono>  // time
+
+namespace screen::trace {
+
+    constexpr uint32_t Magic   = 0x54495053; // "SPIT" in little endian
+    constexpr uint16_t Version = 1;
+
+    // Number of records kept in the ring (8 MB file)
+    constexpr size_t defaultCapacity = 1u << 20;
+
+    // File layout: Header followed by `capacity` Records
+    struct Header {
+
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;
+        uint32_t capacity; // Records in the ring
+        uint32_t head;     // Next slot to be written
+        uint64_t written;  // Total records written since start (may exceed capacity)
+        uint64_t startNs;  // steady_clock timestamp of the first record
+    };
+
+    struct Record {
+
+        uint32_t deltaNs; // Time since the previous record, saturated to UINT32_MAX
+        uint8_t byte;     // Byte sent through SPI
+        uint8_t mode;     // screen::DataMode
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 32, "Unexpected trace header size");
+    static_assert(sizeof(Record) == 8, "Unexpected trace record size");
+
+    enum class ReplaySpeed : uint8_t {
+
+        Original,
+        Maximum
+    };
+
+    struct ReplayStats {
+
+        uint64_t bytes;
+        std::chrono::nanoseconds recorded; // Time span covered by the trace
+        std::chrono::nanoseconds elapsed;  // Time taken to replay it
+    };
+}
+
+#endif // SCREEN_TRACE_H
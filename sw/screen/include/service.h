@@ -5,10 +5,13 @@
 #include <unordered_map> // unordered_map
 #include <atomic>        // atomic
 #include <string_view>   // string_view
+#include <string>        // string
+#include <chrono>        // time
 
 #include <nlohmann/json.hpp>
 
 #include "service_constants.h"
+#include "canvas.h"
 #include "screen.h"
 
 using json = nlohmann::json;
@@ -24,10 +27,24 @@ class Service {
         void run();
         void stop();
 
+        // Async-signal-safe, the dump is written by the service loop
+        void requestMetricsDump();
+
     private:
         std::vector<service::ScreenContext> m_screens;
 
         std::atomic<bool> m_running{true};
+        std::atomic<bool> m_metricsDumpRequested{false};
+
+        // Metrics export
+        std::string m_metricsPath;
+        std::chrono::milliseconds m_metricsInterval = service::defaultMetricsInterval;
+        std::chrono::steady_clock::time_point m_metricsWindowStart;
+        std::chrono::steady_clock::time_point m_metricsNextExport;
+        uint64_t m_wakeups = 0;
+        uint64_t m_windowWakeups = 0;
+        uint64_t m_lateTicks = 0; // Loop iterations that ended after the next one should have started
+        std::chrono::nanoseconds m_tickPeriod = service::defaultTickPeriod;
 
         service::Date m_date{};
         service::Date m_prevDate{};
@@ -35,10 +52,14 @@ class Service {
         service::Time m_time{};
         service::Time m_prevTime{};
         bool m_timeHasChanged = false;
+        uint16_t m_millisecond = 0; // Inside the current second, updated every loop iteration
         service::Network m_net{};
         service::Network m_prevNet{};
         bool m_netHasChanged = false;
 
+        // Analog clock face, rendered once and copied to the bottom layer of each analog clock
+        Canvas m_analogFace{service::AnalogClockFaceSize, service::AnalogClockFaceSize, service::AnalogClockBackground};
+
         // Power State Handler
         bool setPowerState(service::ScreenContext &ctx, bool value);
 
@@ -61,9 +82,10 @@ class Service {
         service::ScreenMode parseScreenMode(const std::string &s);
         service::ScreenSubMode parseScreenSubMode(const std::string &s);
         static screen::Orientation parseOrientation(const std::string &s);
+        static screen::wait::Policy parseWaitPolicy(const std::string &s);
 
         // Render
-        bool renderTextBlock(Screen &s, const service::TextBlock &block, std::string_view text);
+        bool renderTextBlock(service::ScreenContext &ctx, const service::TextBlock &block, std::string_view text);
         bool renderBitmapBlock(Screen &s, const service::BitmapBlock &block, std::vector<screen::Color> &bitmap);
 
         void renderDateString(service::ScreenContext &ctx);
@@ -74,6 +96,7 @@ class Service {
 
         void renderAnalogClockFace(service::ScreenContext &ctx);
         void renderAnalogClockHands(service::ScreenContext &ctx, const bool forceFullRender);
+        void buildAnalogClockFace();
 
         // Date, Time and IP updaters
         void updateDateAndTime();
@@ -81,6 +104,12 @@ class Service {
         bool hasCarrier(const char *iface);
         std::string formatIPv4(uint32_t ip);
 
+        // Metrics
+        void updateMetrics();
+        std::string formatMetrics() const;
+        bool exportMetrics(const std::string &path) const;
+        void resetMetricsWindow();
+
         // Full test routine
         void runTests();
 };
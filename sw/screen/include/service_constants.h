@@ -1,10 +1,16 @@
 #ifndef SERVICE_CONSTANTS_H
 #define SERVICE_CONSTANTS_H
 
-#include <cstdint> // uint
-#include <memory>  // unique_ptr
+#include <cstdint>       // uint
+#include <memory>        // unique_ptr
+#include <chrono>        // time
+#include <vector>        // vector
+#include <unordered_map> // unordered_map
 
 #include "screen_constants.h"
+#include "screen_metrics.h"
+#include "text_layout.h"
+#include "compositor.h"
 #include "screen.h"
 
 namespace service {
@@ -23,7 +29,38 @@ namespace service {
         HourMinute,
         HourMinuteSecond,
         HourMinuteTick,
-        HourMinuteColonTick
+        HourMinuteColonTick,
+        HourMinuteSweep // AnalogClock only, second hand redrawn at the screen frame rate
+    };
+
+    // Service loop period, shortened to the highest frame rate of the sweeping clocks
+    constexpr std::chrono::milliseconds defaultTickPeriod = std::chrono::milliseconds(100);
+
+    // Frames per second of the sweeping second hand, "fps" in the screen config
+    constexpr uint8_t defaultSweepFps = 20;
+    constexpr uint8_t MinSweepFps     = 10;
+    constexpr uint8_t MaxSweepFps     = 30;
+
+    struct ScreenStats {
+
+        uint64_t framesRendered = 0;
+        uint64_t windowBusyNs = 0; // Screen busy time at the start of the export window
+        uint64_t layoutHits = 0;   // Text blocks updated with the text already laid out
+        uint64_t layoutMisses = 0;
+        uint64_t textCellWindows = 0; // Windows of changed glyph cells sent to update text lines
+        screen::metrics::Stat render;
+        screen::metrics::Stat sweep;  // Sweep frames, including the ones where nothing moved
+        screen::metrics::StatSnapshot windowRender{}; // Stats at the start of the export window, for the quantiles
+        screen::metrics::StatSnapshot windowSweep{};
+    };
+
+    struct TextBlock;
+
+    // Layout of a text block and the lines currently shown on the screen
+    struct TextBlockState {
+
+        TextLayout layout;
+        std::vector<screen::text::Line> shown;
     };
 
     struct ScreenContext {
@@ -34,8 +71,15 @@ namespace service {
         service::ScreenMode mode;
         service::ScreenSubMode subMode;
         bool enteringNewMode;
+        std::unique_ptr<ScreenStats> stats = std::make_unique<ScreenStats>();
+        std::unordered_map<const TextBlock *, TextBlockState> text{}; // Forgotten when the screen is cleared
+        std::unique_ptr<Compositor> clock{}; // Analog clock layers, created when the mode is first entered
+        uint8_t sweepFps = defaultSweepFps;
+        std::chrono::steady_clock::time_point nextSweepFrame{};
     };
 
+    constexpr std::chrono::milliseconds defaultMetricsInterval = std::chrono::milliseconds(10000);
+
     struct Date {
 
         uint16_t year;
@@ -67,6 +111,9 @@ namespace service {
 
         const screen::Font &font;
         screen::Color color;
+        screen::Color background = screen::StandardColor::Black;
+
+        screen::text::Style style = {};
     };
 
     inline const TextBlock InfoDateBlock        { 0, 0,  96,  8, screen::Font8x8, screen::StandardColor::White};
@@ -114,6 +161,35 @@ namespace service {
 
     constexpr uint8_t AnalogClockHourHandLength   = 10;
     constexpr uint8_t AnalogClockMinuteHandLength = 20;
+
+    // Analog clock face, a square left of the seconds with the hands pivoting on one pixel
+    constexpr uint8_t AnalogClockFaceX    = 16;
+    constexpr uint8_t AnalogClockFaceY    = 0;
+    constexpr uint8_t AnalogClockFaceSize = 64;
+    constexpr uint8_t AnalogClockCenterX  = 47;
+    constexpr uint8_t AnalogClockCenterY  = 31;
+    constexpr uint8_t AnalogClockRadius   = 31;
+
+    // Hour ticks run between these distances from the center
+    constexpr uint8_t AnalogClockTickInner = 25;
+    constexpr uint8_t AnalogClockTickOuter = 28;
+
+    constexpr screen::Color AnalogClockColor      = screen::StandardColor::White;
+    constexpr screen::Color AnalogClockBackground = screen::StandardColor::Black;
+
+    // Seconds marker between the tip of the minute hand and the ticks
+    constexpr uint8_t AnalogClockSecondRadius = 23;
+    constexpr screen::Color AnalogClockSecondColor = screen::StandardColor::Red;
+
+    // Sweeping second hand, one position per frame at the highest frame rate
+    constexpr uint8_t AnalogClockSecondHandLength = 24;
+    constexpr size_t AnalogClockSweepSteps = 60 * MaxSweepFps;
+
+    // Analog clock layers, from the bottom
+    constexpr size_t AnalogClockFaceLayer   = 0;
+    constexpr size_t AnalogClockHandsLayer  = 1;
+    constexpr size_t AnalogClockSecondLayer = 2;
+    constexpr size_t AnalogClockLayers      = 3;
 }
 
 #endif // SERVICE_CONSTANTS_H
\ No newline at end of file
@@ -20,6 +20,10 @@ class Test {
         void onOff();
         void display();
         void randomPattern();
+        void spiClock();
+        void dma();
+        void interrupt();
+        void commandCache();
         void colorDepth();
         void addressIncrement();
         void bitmap();
@@ -27,11 +31,16 @@ class Test {
         void line();
         void rectangle();
         void circle();
+        void canvas();
+        void compositor();
         void clear();
         void copy();
         void image();
         void symbol();
         void string();
+        void bitmapFont();
+        void textLayout();
+        void utf8();
         void standardColors();
         void inverseDisplay();
         void remap();
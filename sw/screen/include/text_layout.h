@@ -0,0 +1,110 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <cstdint>     // uint
+#include <cstddef>     // size_t
+#include <string>      // string
+#include <string_view> // string_view
+#include <vector>      // vector
+#include <span>        // span
+
+#include "bitmap_font.h"
+
+namespace screen::text {
+
+    enum class Align : uint8_t {
+
+        Left,
+        Center,
+        Right
+    };
+
+    enum class Overflow : uint8_t {
+
+        Clip,     // One line, cut at the last glyph that fits
+        Ellipsis, // One line, ended with an ellipsis when cut
+        Wrap      // Word wrapped lines, the last one ended with an ellipsis when cut
+    };
+
+    struct Box {
+
+        uint8_t x;
+        uint8_t y;
+        uint8_t width;
+        uint8_t height;
+
+        bool operator==(const Box &) const = default;
+    };
+
+    struct Style {
+
+        Align align = Align::Left;
+        Overflow overflow = Overflow::Ellipsis;
+        uint8_t lineSpacing = 0;
+
+        bool operator==(const Style &) const = default;
+    };
+
+    // U+2026, replaced by "..." in fonts without it
+    constexpr uint32_t EllipsisCodepoint = 0x2026;
+
+    struct Line {
+
+        uint8_t offset;               // Pixels from the left of the box, after alignment
+        std::vector<uint32_t> glyphs; // Glyph indices of the font
+
+        bool operator==(const Line &) const = default;
+    };
+
+    struct Layout {
+
+        std::vector<Line> lines;
+        bool truncated = false;
+    };
+
+    // Columns [begin, end) of a box
+    struct Columns {
+
+        uint8_t begin;
+        uint8_t end;
+
+        bool operator==(const Columns &) const = default;
+    };
+
+    // Pixels covered by a run of glyphs drawn from pen position 0
+    size_t extent(const BitmapFont &font, std::span<const uint32_t> glyphs);
+
+    // Columns of a box of width pixels that differ between two lines, sorted and merged.
+    // A glyph cell is unchanged when the same glyph sits at the same position in both lines
+    std::vector<Columns> changedColumns(const BitmapFont &font, const Line &before, const Line &after, uint8_t width);
+}
+
+// Lays out text inside a box and keeps the result until the text, font, box or style change
+class TextLayout {
+
+    public:
+        // Returns true when the text had to be laid out again
+        bool update(std::string_view text, const BitmapFont &font, screen::text::Box box, screen::text::Style style);
+
+        const screen::text::Layout &layout() const;
+
+        // Top of a line inside the box
+        uint8_t lineY(size_t line) const;
+
+    private:
+        bool m_valid = false;
+        std::string m_text;
+        const BitmapFont *m_font = nullptr;
+        screen::text::Box m_box{};
+        screen::text::Style m_style{};
+
+        screen::text::Layout m_layout;
+        std::vector<uint32_t> m_codepoints;
+
+        void build();
+        void addLine(std::vector<uint32_t> &glyphs);
+        void ellipsise(std::vector<uint32_t> &glyphs) const;
+        size_t maxLines() const;
+};
+
+#endif // TEXT_LAYOUT_H
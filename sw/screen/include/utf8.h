@@ -0,0 +1,82 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <cstdint>     // uint
+#include <cstddef>     // size_t
+#include <string_view> // string_view
+#include <vector>      // vector
+
+namespace screen::utf8 {
+
+    // Decoded for invalid, overlong, surrogate or truncated sequences
+    constexpr uint32_t Replacement = 0xFFFD;
+
+    // Decodes the codepoint at pos and advances pos past it, never reading past the end of text.
+    // A bad sequence decodes to Replacement and only consumes its valid prefix (at least one byte).
+    constexpr uint32_t decode(std::string_view text, size_t &pos) {
+
+        const uint8_t lead = static_cast<uint8_t>(text[pos++]);
+
+        if (lead < 0x80) {
+            return lead;
+        }
+
+        size_t n = 0;
+        uint32_t codepoint = 0;
+        uint8_t low = 0x80;  // Range of the second byte, rejects overlongs and surrogates
+        uint8_t high = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            n = 1;
+            codepoint = lead & 0x1F;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            n = 2;
+            codepoint = lead & 0x0F;
+            low = (lead == 0xE0) ? 0xA0 : 0x80;
+            high = (lead == 0xED) ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            n = 3;
+            codepoint = lead & 0x07;
+            low = (lead == 0xF0) ? 0x90 : 0x80;
+            high = (lead == 0xF4) ? 0x8F : 0xBF;
+        } else {
+            return Replacement;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (pos >= text.size()) {
+                return Replacement;
+            }
+            const uint8_t byte = static_cast<uint8_t>(text[pos]);
+            if (byte < low || byte > high) {
+                return Replacement;
+            }
+            codepoint = (codepoint << 6) | (byte & 0x3F);
+            pos++;
+            low = 0x80;
+            high = 0xBF;
+        }
+
+        return codepoint;
+    }
+
+    // Appends every codepoint of text to out, copying runs of ASCII 8 bytes at a time
+    void decode(std::string_view text, std::vector<uint32_t> &out);
+
+    constexpr bool decodesTo(std::string_view text, uint32_t expected, size_t expectedLength) {
+
+        size_t pos = 0;
+        return decode(text, pos) == expected && pos == expectedLength;
+    }
+
+    static_assert(decodesTo("A", 'A', 1));
+    static_assert(decodesTo("\xC3\xA9", 0xE9, 2));
+    static_assert(decodesTo("\xE2\x82\xAC", 0x20AC, 3));
+    static_assert(decodesTo("\xF0\x9F\x98\x80", 0x1F600, 4));
+    static_assert(decodesTo("\xC0\x80", Replacement, 1));     // Overlong
+    static_assert(decodesTo("\xED\xA0\x80", Replacement, 1)); // Surrogate
+    static_assert(decodesTo("\xE2\x82", Replacement, 2));     // Truncated
+    static_assert(decodesTo("\xE2\x41", Replacement, 1));     // Bad continuation
+}
+
+#endif // UTF8_H
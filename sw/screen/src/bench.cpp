@@ -0,0 +1,383 @@
+#include <iostream> // cout, endl
+#include <vector>   // vector
+#include <random>   // mt19937
+#include <ctime>    // clock_gettime
+
+#include <nlohmann/json.hpp>
+
+#include "paths.h"
+#include "screen_constants.h"
+#include "screen_registers.h"
+#include "pixel_encoding.h"
+#include "bitmap_font.h"
+#include "utf8.h"
+#include "canvas.h"
+#include "compositor.h"
+#include "screen.h"
+#include "bench.h"
+
+#ifndef SCREEN_GIT_REV
+#define SCREEN_GIT_REV "unknown"
+#endif
+
+using json = nlohmann::json;
+
+Bench::Bench(Screen &screen, const std::string &filter) : m_screen(screen), m_filter(filter) {
+}
+
+void Bench::full() {
+
+    m_screen.clearScreen();
+    m_screen.applyDefaultSettings();
+
+    fullFrameBitmap();
+    waitPolicy();
+    string();
+    utf8();
+    glyph();
+    glyphRaster();
+    line();
+    circle();
+    canvas();
+    compositor();
+    imageImport();
+    clear();
+    copy();
+
+    m_screen.clearScreen();
+    m_screen.applyDefaultSettings();
+}
+
+void Bench::fullFrameBitmap() {
+
+    std::vector<screen::Color> colors(screen::Geometry::Pixels);
+
+    std::mt19937 gen(bench::Seed);
+    std::uniform_int_distribution<uint8_t> dist31(0, 31);
+    std::uniform_int_distribution<uint8_t> dist63(0, 63);
+
+    for (screen::Color &c : colors) {
+        c = {dist31(gen), dist63(gen), dist31(gen)};
+    }
+
+    measure("bitmap_full_frame", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    // Same frame with the other color depths
+    m_screen.setColorDepth(screen::RemapColorDepth::ColorDepth::Color256);
+    m_screen.applyRemapColorDepth();
+    measure("bitmap_full_frame_256", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.setColorDepth(screen::RemapColorDepth::ColorDepth::Color65kAlt);
+    m_screen.applyRemapColorDepth();
+    measure("bitmap_full_frame_65k_alt", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.applyRemapColorDepth(screen::ApplyMode::Default);
+
+    // Small sprite redrawn in place, the cache skips the six bytes of window commands in front of each one
+    const std::vector<screen::Color> sprite(colors.begin(), colors.begin() + bench::SpriteSize * bench::SpriteSize);
+    measure("bitmap_same_window_cached", bench::SpriteIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, bench::SpriteSize - 1, bench::SpriteSize - 1, sprite);
+    });
+
+    m_screen.setCommandCacheEnable(false);
+    measure("bitmap_same_window_uncached", bench::SpriteIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, bench::SpriteSize - 1, bench::SpriteSize - 1, sprite);
+    });
+    m_screen.setCommandCacheEnable(true);
+
+    // Encoding only, without SPI
+    std::vector<uint8_t> bytes(colors.size() * screen::encoding::MaxBytes);
+    volatile uint8_t sink = 0; // Keeps the encoded bytes alive
+
+    measure("pixel_encode_65k", bench::EncodeIterations, [&](uint64_t i) {
+        screen::encoding::packPixels<screen::encoding::Color65k>(colors.data(), colors.size(), bytes.data());
+        sink = bytes[i % bytes.size()];
+    });
+}
+
+void Bench::waitPolicy() {
+
+    const std::vector<screen::Color> colors(screen::Geometry::Pixels, screen::StandardColor::Teal);
+
+    // Same frame with each wait policy, cpu_s against wall_s is the CPU the waits take
+    m_screen.setWaitPolicy(screen::wait::Policy::Spin);
+    measure("bitmap_full_frame_spin", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.setWaitPolicy(screen::wait::Policy::Yield);
+    measure("bitmap_full_frame_yield", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.setWaitPolicy(screen::wait::Policy::Hybrid);
+    measure("bitmap_full_frame_hybrid", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.setWaitPolicy(screen::wait::Policy::Adaptive);
+    measure("bitmap_full_frame_adaptive", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    // A short SPI delay after each byte, slept or busy-waited
+    const std::vector<screen::Color> row(colors.begin(), colors.begin() + screen::Geometry::Columns);
+    m_screen.setSpiDelay(bench::ShortSpiDelay);
+
+    m_screen.setWaitPolicy(screen::wait::Policy::Hybrid);
+    measure("bitmap_row_spi_delay_sleep", bench::DelayIterations, [&](uint64_t i) {
+        const uint8_t y = i % screen::Geometry::Rows;
+        m_screen.drawBitmap(0, y, screen::Geometry::Columns - 1, y, row);
+    });
+
+    m_screen.setWaitPolicy(screen::wait::Policy::Adaptive);
+    measure("bitmap_row_spi_delay_adaptive", bench::DelayIterations, [&](uint64_t i) {
+        const uint8_t y = i % screen::Geometry::Rows;
+        m_screen.drawBitmap(0, y, screen::Geometry::Columns - 1, y, row);
+    });
+
+    m_screen.setSpiDelay(screen::defaultSpiDelay);
+    m_screen.setWaitPolicy(screen::wait::defaultPolicy);
+
+    // Posted bursts against one SPI_CTRL write per byte, same on IPs without the TX queue
+    m_screen.setDmaEnable(false);
+    measure("bitmap_full_frame_tx_fifo", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+
+    m_screen.setTxFifoEnable(false);
+    measure("bitmap_full_frame_spi_ctrl", bench::FrameIterations, [&](uint64_t) {
+        m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+    });
+    m_screen.setTxFifoEnable(true);
+    m_screen.setDmaEnable(true);
+
+    // Whole frames from the DMA buffer, the CPU time is the encoding and the wait for the previous frame
+    if (m_screen.hasDma()) {
+        measure("bitmap_full_frame_dma", bench::FrameIterations, [&](uint64_t) {
+            m_screen.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);
+        });
+    }
+}
+
+void Bench::string() {
+
+    const std::string phrase = "Pmod OLEDrgb 16c"; // 16 chars, 96 px wide with Font6x8
+
+    measure("string_16_chars", bench::StringIterations, [&](uint64_t i) {
+        m_screen.drawString(phrase, 0, (i % 8) * screen::Font6x8.height, screen::Font6x8, screen::StandardColor::White);
+    });
+}
+
+void Bench::utf8() {
+
+    // Mostly ASCII with some 2, 3 and 4 byte sequences, as in dates and labels
+    std::string text;
+    while (text.size() < bench::TextBytes) {
+        text += "Pmod OLEDrgb 12:34:56 192.168.1.10 \u00e1\u00e9\u00ed \u20ac \U0001F600 ";
+    }
+
+    std::vector<uint32_t> codepoints;
+    std::vector<uint32_t> run;
+    const BitmapFont font = BitmapFont::fromFont(screen::Font6x8);
+    volatile uint32_t sink = 0;
+
+    measure("utf8_decode", bench::TextIterations, [&](uint64_t i) {
+        codepoints.clear();
+        screen::utf8::decode(text, codepoints);
+        sink = codepoints[i % codepoints.size()];
+    });
+
+    measure("text_shape", bench::TextIterations, [&](uint64_t i) {
+        font.shape(text, run);
+        sink = run[i % run.size()];
+    });
+}
+
+void Bench::glyph() {
+
+    const uint8_t textCols = screen::Geometry::Columns / screen::Font8x8.width;
+    const uint8_t textRows = screen::Geometry::Rows / screen::Font8x8.height;
+
+    measure("glyph_8x8", bench::GlyphIterations, [&](uint64_t i) {
+        const uint8_t x = (i % textCols) * screen::Font8x8.width;
+        const uint8_t y = ((i / textCols) % textRows) * screen::Font8x8.height;
+        m_screen.drawSymbol(static_cast<uint8_t>('!' + i % 94), x, y, screen::Font8x8, screen::StandardColor::White);
+    });
+}
+
+void Bench::glyphRaster() {
+
+    // Glyph to bitmap only, without SPI
+    volatile uint8_t sink = 0;
+
+    measure("glyph_raster_8x8", bench::RasterIterations, [&](uint64_t i) {
+        std::vector<screen::Color> bitmap = m_screen.importSymbolAsBitmap(static_cast<uint8_t>('!' + i % 94), screen::Font8x8, screen::StandardColor::White);
+        sink = bitmap[i % bitmap.size()].g;
+    });
+
+    // Full width line of 16 cached glyphs, encoded for the current depth
+    const BitmapFont &font = BitmapFont::builtin(screen::Font6x8);
+    std::vector<uint32_t> run;
+    font.shape("12:34:56 Pmod 96", run);
+
+    measure("text_line_compose", bench::RasterIterations, [&](uint64_t i) {
+        m_screen.composeRun(run, screen::Geometry::Columns, 0, font, screen::StandardColor::White, screen::StandardColor::Black);
+        sink = m_screen.m_pixelBuffer[i % m_screen.m_pixelBuffer.size()];
+    });
+
+    // Same with the 4 bit fixture, blended through the ramp on a colored background
+    BitmapFont smooth;
+    if (!smooth.load(AppPaths::FONTS_DIR + bench::SmoothFont)) {
+        std::cerr << "Font load failed: " << AppPaths::FONTS_DIR + bench::SmoothFont << std::endl;
+        return;
+    }
+    smooth.shape("12:34:56 Pmod", run);
+
+    measure("text_line_compose_aa", bench::RasterIterations, [&](uint64_t i) {
+        m_screen.composeRun(run, screen::Geometry::Columns, 0, smooth, screen::StandardColor::Yellow, screen::StandardColor::Blue);
+        sink = m_screen.m_pixelBuffer[i % m_screen.m_pixelBuffer.size()];
+    });
+}
+
+void Bench::line() {
+
+    std::mt19937 gen(bench::Seed);
+    std::uniform_int_distribution<uint8_t> col(0, screen::Geometry::Columns - 1);
+    std::uniform_int_distribution<uint8_t> row(0, screen::Geometry::Rows - 1);
+
+    measure("line", bench::LineIterations, [&](uint64_t) {
+        m_screen.drawLine(col(gen), row(gen), col(gen), row(gen), screen::StandardColor::Green);
+    });
+}
+
+void Bench::circle() {
+
+    const uint8_t d = screen::Geometry::Rows;
+    const uint8_t x = (screen::Geometry::Columns - d) / 2;
+
+    measure("circle_64", bench::CircleIterations, [&](uint64_t) {
+        m_screen.drawCircle(x, 0, d, screen::StandardColor::White);
+    });
+}
+
+void Bench::canvas() {
+
+    Canvas canvas;
+    volatile uint8_t sink = 0;
+
+    // Dashboard of a dozen shapes, composed only, then composed and sent in one window
+    auto compose = [&](uint64_t i) {
+        const int angle = static_cast<int>(i % 360);
+        canvas.clear(screen::StandardColor::Black);
+        canvas.fillRoundedRect(0, 0, screen::Geometry::Columns - 1, 11, 4, screen::StandardColor::Blue);
+        canvas.drawArc(20, 34, 16, 4, 0, static_cast<float>(angle), screen::StandardColor::Green);
+        canvas.fillCircle(20, 34, 3, screen::StandardColor::Red);
+        canvas.fillEllipse(60, 34, 12, 8, screen::StandardColor::Cyan);
+        canvas.drawThickLine(48, 50, 72, 20 + angle % 30, 3, screen::StandardColor::White);
+        const screen::canvas::Point arrow[] = {{54, 30}, {66, 34}, {54, 38}};
+        canvas.fillPolygon(arrow, screen::StandardColor::Black);
+        for (int bar = 0; bar < 4; bar++) {
+            canvas.fillRect(78 + bar * 4, 40 - bar * 8, 80 + bar * 4, 60, screen::StandardColor::Yellow);
+        }
+    };
+
+    measure("canvas_compose", bench::CanvasIterations, [&](uint64_t i) {
+        compose(i);
+        sink = canvas.pixel(20, 20).g;
+    });
+
+    measure("canvas_flush", bench::FrameIterations, [&](uint64_t i) {
+        compose(i);
+        m_screen.drawCanvas(canvas);
+    });
+}
+
+void Bench::compositor() {
+
+    Compositor stack(screen::Geometry::Columns, screen::Geometry::Rows, 2);
+    stack.layer(0).fillCircle(47, 31, 31, screen::StandardColor::Blue);
+
+    // A hand sweeping over a static face, composed and only the changed pixels sent
+    measure("compositor_flush", bench::CanvasIterations, [&](uint64_t i) {
+        const int angle = static_cast<int>(i % 60);
+        stack.clearLayer(1);
+        stack.layer(1).drawThickLine(47, 31, 47 + (angle % 30) - 15, (angle < 30) ? 2 : 60, 2, screen::StandardColor::White);
+        m_screen.drawCanvas(stack.composite(), stack.compose());
+    });
+}
+
+void Bench::imageImport() {
+
+    const std::string imagePath = AppPaths::IMAGES_DIR + "default1.jpg";
+
+    measure("image_import", bench::ImageIterations, [&](uint64_t) {
+        std::vector<screen::Color> bitmap = m_screen.importImageAsBitmap(imagePath);
+        if (bitmap.empty()) {
+            std::cerr << "Image import failed: " << imagePath << std::endl;
+        }
+    });
+}
+
+void Bench::clear() {
+
+    measure("clear_screen", bench::ClearIterations, [&](uint64_t) {
+        m_screen.clearScreen();
+    });
+}
+
+void Bench::copy() {
+
+    const uint8_t half = screen::Geometry::Columns / 2;
+
+    measure("copy_half", bench::CopyIterations, [&](uint64_t) {
+        m_screen.copyWindow(0, 0, half - 2, screen::Geometry::Rows - 2, half, 0);
+    });
+}
+
+json Bench::results() const {
+
+    const bool emulated = m_screen.getEmulator() != nullptr;
+
+    json j;
+    j["revision"] = SCREEN_GIT_REV;
+    j["backend"] = emulated ? "emulator" : "uio";
+    j["results"] = json::array();
+
+    for (const bench::Result &r : m_results) {
+        json result = {
+            {"name",        r.name},
+            {"iterations",  r.iterations},
+            {"wall_s",      r.wallSec},
+            {"cpu_s",       r.cpuSec},
+            {"bytes",       r.bytes},
+            {"ops_per_s",   (r.wallSec > 0) ? r.iterations / r.wallSec : 0.0},
+            {"bytes_per_s", (r.wallSec > 0) ? r.bytes / r.wallSec : 0.0}
+        };
+        if (emulated) {
+            result["wire_s"] = r.wireSec;
+        }
+        j["results"].push_back(result);
+    }
+
+    return j;
+}
+
+double Bench::cpuTimeSec() {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+double Bench::wireTimeSec() const {
+
+    const Emulator *emulator = m_screen.getEmulator();
+    return emulator ? std::chrono::duration<double>(emulator->wireTime()).count() : 0.0;
+}
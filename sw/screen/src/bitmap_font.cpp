@@ -0,0 +1,448 @@
+#include <iostream>  // cerr, endl
+#include <fstream>   // ifstream
+#include <sstream>   // istringstream
+#include <string>    // string
+#include <algorithm> // max, min
+#include <cstring>   // memcpy
+#include <iterator>  // istreambuf_iterator
+#include <map>       // map
+#include <tuple>     // tuple
+#include <mutex>     // mutex, lock_guard
+#include <atomic>    // atomic
+
+#include "screen_constants.h"
+#include "glyph_masks.h"
+#include "utf8.h"
+#include "bitmap_font.h"
+
+namespace {
+
+    // -1 for characters that are not hexadecimal digits
+    int hexNibble(char c) {
+
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    bool hasExtension(const std::string &path, const std::string &ext) {
+
+        return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+    }
+
+    std::atomic<uint64_t> nextFontId{1};
+}
+
+BitmapFont::BitmapFont() {
+
+    m_direct.fill(screen::fonts::NoGlyph);
+}
+
+BitmapFont BitmapFont::fromFont(const screen::Font &font) {
+
+    BitmapFont f;
+    f.clear(font.height, 1);
+
+    for (uint32_t symbol = 0; symbol < 256; symbol++) {
+        const uint32_t index = f.addGlyph(font.width, font.width);
+        std::memcpy(&f.m_atlas[f.m_glyphs[index].offset], &font.bitmap[symbol * font.height], font.height);
+        f.map(symbol, index);
+    }
+
+    return f;
+}
+
+const BitmapFont &BitmapFont::builtin(const screen::Font &font) {
+
+    static std::mutex mutex;
+    static std::map<std::tuple<const uint8_t *, uint8_t, uint8_t>, BitmapFont> fonts;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto [it, inserted] = fonts.try_emplace({font.bitmap, font.width, font.height});
+    if (inserted) {
+        it->second = fromFont(font);
+    }
+    return it->second;
+}
+
+bool BitmapFont::load(const std::string &path) {
+
+    if (hasExtension(path, ".bdf")) {
+        return loadBdf(path);
+    }
+    if (hasExtension(path, ".psf") || hasExtension(path, ".psfu")) {
+        return loadPsf2(path);
+    }
+
+    std::cerr << "Unknown font format: " << path << std::endl;
+    return false;
+}
+
+bool BitmapFont::loadPsf2(const std::string &path) {
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open font: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    screen::fonts::Psf2Header header{};
+    if (data.size() < sizeof(header)) {
+        std::cerr << "Invalid PSF2 font: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    const uint32_t rowBytes = (header.width + 7) / 8;
+
+    if (header.magic != screen::fonts::Psf2Magic || header.headerSize < sizeof(header) ||
+        header.width == 0 || header.width > screen::fonts::MaxGlyphWidth ||
+        header.height == 0 || header.height > screen::fonts::MaxGlyphHeight ||
+        header.charSize != rowBytes * header.height ||
+        header.headerSize + static_cast<uint64_t>(header.length) * header.charSize > data.size()) {
+        std::cerr << "Invalid PSF2 font: " << path << std::endl;
+        return false;
+    }
+
+    clear(static_cast<uint8_t>(header.height), 1);
+
+    // PSF2 rows have the leftmost pixel in the MSB
+    const uint8_t *glyphs = &data[header.headerSize];
+    for (uint32_t g = 0; g < header.length; g++) {
+        const uint32_t index = addGlyph(static_cast<uint8_t>(header.width), static_cast<uint8_t>(header.width));
+        const uint8_t *src = &glyphs[g * header.charSize];
+        for (size_t row = 0; row < header.height; row++) {
+            for (size_t col = 0; col < header.width; col++) {
+                if (src[row * rowBytes + col / 8] & (0x80 >> (col % 8))) {
+                    setPixel(m_glyphs[index], row, col);
+                }
+            }
+        }
+    }
+
+    if (!(header.flags & screen::fonts::Psf2HasUnicodeTable)) {
+        for (uint32_t g = 0; g < header.length; g++) {
+            map(g, g);
+        }
+        return true;
+    }
+
+    // Unicode table: for each glyph, its codepoints, then sequences after 0xFE, then 0xFF
+    const std::string_view table(reinterpret_cast<const char *>(data.data()), data.size());
+    size_t pos = header.headerSize + static_cast<size_t>(header.length) * header.charSize;
+    for (uint32_t g = 0; g < header.length && pos < data.size(); g++) {
+        bool sequence = false;
+        while (pos < data.size() && data[pos] != screen::fonts::Psf2UnicodeEnd) {
+            if (data[pos] == screen::fonts::Psf2UnicodeStart) {
+                sequence = true;
+                pos++;
+                continue;
+            }
+            const uint32_t codepoint = screen::utf8::decode(table, pos);
+            if (!sequence && codepoint != screen::utf8::Replacement) {
+                map(codepoint, g);
+            }
+        }
+        pos++;
+    }
+
+    return true;
+}
+
+bool BitmapFont::loadBdf(const std::string &path) {
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open font: " << path << std::endl;
+        return false;
+    }
+
+    // Font cell
+    int boxHeight = 0;
+    int boxYOffset = 0;
+    int ascent = -1;
+    int descent = -1;
+    int bitsPerPixel = 1;
+
+    // Current glyph
+    long encoding = -1;
+    int advance = 0;
+    int bbxWidth = 0;
+    int bbxHeight = 0;
+    int bbxXOffset = 0;
+    int bbxYOffset = 0;
+    std::vector<std::string> rows;
+
+    bool started = false;
+    bool inBitmap = false;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string keyword;
+        in >> keyword;
+
+        if (inBitmap) {
+            if (keyword != "ENDCHAR") {
+                rows.push_back(keyword);
+                continue;
+            }
+            inBitmap = false;
+        }
+
+        if (keyword == "SIZE") {
+            // Anti-aliased BDF fonts give their depth after the resolution
+            int points = 0;
+            int xres = 0;
+            int yres = 0;
+            in >> points >> xres >> yres;
+            if (!(in >> bitsPerPixel)) {
+                bitsPerPixel = 1;
+            }
+            if (bitsPerPixel != 1 && bitsPerPixel != 2 && bitsPerPixel != 4 && bitsPerPixel != 8) {
+                std::cerr << "Invalid BDF font depth: " << path << std::endl;
+                return false;
+            }
+        } else if (keyword == "FONTBOUNDINGBOX") {
+            int boxWidth = 0;
+            int boxXOffset = 0;
+            in >> boxWidth >> boxHeight >> boxXOffset >> boxYOffset;
+        } else if (keyword == "FONT_ASCENT") {
+            in >> ascent;
+        } else if (keyword == "FONT_DESCENT") {
+            in >> descent;
+        } else if (keyword == "CHARS") {
+            // Cell height is known once the properties are read
+            if (ascent < 0 || descent < 0) {
+                ascent = boxHeight + boxYOffset;
+                descent = -boxYOffset;
+            }
+            if (ascent + descent <= 0 || ascent + descent > static_cast<int>(screen::fonts::MaxGlyphHeight)) {
+                std::cerr << "Invalid BDF font height: " << path << std::endl;
+                return false;
+            }
+            clear(static_cast<uint8_t>(ascent + descent), static_cast<uint8_t>(std::min<int>(bitsPerPixel, screen::fonts::MaxBitsPerPixel)));
+            started = true;
+        } else if (keyword == "STARTCHAR") {
+            encoding = -1;
+            advance = 0;
+            bbxWidth = bbxHeight = bbxXOffset = bbxYOffset = 0;
+            rows.clear();
+        } else if (keyword == "ENCODING") {
+            in >> encoding;
+        } else if (keyword == "DWIDTH") {
+            in >> advance;
+        } else if (keyword == "BBX") {
+            in >> bbxWidth >> bbxHeight >> bbxXOffset >> bbxYOffset;
+        } else if (keyword == "BITMAP") {
+            inBitmap = true;
+        } else if (keyword == "ENDCHAR") {
+            if (!started || encoding < 0) {
+                continue;
+            }
+
+            // Glyph cell from the origin to the advance, widened for glyphs that overhang it
+            const int left = std::min(bbxXOffset, 0);
+            const int width = std::max(advance, bbxXOffset + bbxWidth) - left;
+            if (width <= 0 || width > static_cast<int>(screen::fonts::MaxGlyphWidth)) {
+                continue;
+            }
+
+            const uint32_t index = addGlyph(static_cast<uint8_t>(width), static_cast<uint8_t>(std::clamp(advance, 0, 255)));
+            const int top = ascent - (bbxYOffset + bbxHeight);
+
+            for (int r = 0; r < bbxHeight && r < static_cast<int>(rows.size()); r++) {
+                const int row = top + r;
+                if (row < 0 || row >= m_height) {
+                    continue;
+                }
+                // Hex rows, leftmost pixel in the most significant bits of the first byte.
+                // 8 bit pixels keep their high nibble.
+                const std::string &hex = rows[r];
+                const int depth = std::min(bitsPerPixel, 4);
+                const int pixelsPerNibble = 4 / depth;
+                const int nibbleStep = bitsPerPixel / depth;
+                for (int c = 0; c < bbxWidth && static_cast<size_t>(c / pixelsPerNibble * nibbleStep) < hex.size(); c++) {
+                    const int nibble = hexNibble(hex[c / pixelsPerNibble * nibbleStep]);
+                    if (nibble <= 0) {
+                        continue;
+                    }
+                    const int shift = 4 - depth * (c % pixelsPerNibble + 1);
+                    const uint8_t level = static_cast<uint8_t>((nibble >> shift) & ((1 << depth) - 1));
+                    if (level) {
+                        setLevel(m_glyphs[index], row, bbxXOffset - left + c, level);
+                    }
+                }
+            }
+
+            map(static_cast<uint32_t>(encoding), index);
+        }
+    }
+
+    if (m_glyphs.empty()) {
+        std::cerr << "No glyphs in BDF font: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BitmapFont::empty() const {
+
+    return m_glyphs.empty();
+}
+
+uint8_t BitmapFont::height() const {
+
+    return m_height;
+}
+
+size_t BitmapFont::glyphCount() const {
+
+    return m_glyphs.size();
+}
+
+uint8_t BitmapFont::bitsPerPixel() const {
+
+    return m_bitsPerPixel;
+}
+
+uint64_t BitmapFont::id() const {
+
+    return m_id;
+}
+
+const BitmapFont::Glyph *BitmapFont::find(uint32_t codepoint) const {
+
+    if (codepoint < screen::fonts::DirectCodepoints) {
+        const uint32_t index = m_direct[codepoint];
+        return (index != screen::fonts::NoGlyph) ? &m_glyphs[index] : nullptr;
+    }
+
+    auto it = m_index.find(codepoint);
+    return (it != m_index.end()) ? &m_glyphs[it->second] : nullptr;
+}
+
+const BitmapFont::Glyph &BitmapFont::glyphOrFallback(uint32_t codepoint) const {
+
+    return m_glyphs[glyphIndex(codepoint)];
+}
+
+const BitmapFont::Glyph &BitmapFont::glyph(uint32_t index) const {
+
+    return m_glyphs[index];
+}
+
+void BitmapFont::shape(std::string_view text, std::vector<uint32_t> &run) const {
+
+    run.clear();
+    run.reserve(text.size());
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const uint8_t byte = static_cast<uint8_t>(text[pos]);
+
+        // ASCII fast path, without decoding nor hashing
+        if (byte < screen::fonts::DirectCodepoints && m_direct[byte] != screen::fonts::NoGlyph) {
+            run.push_back(m_direct[byte]);
+            pos++;
+            continue;
+        }
+
+        run.push_back(glyphIndex(screen::utf8::decode(text, pos)));
+    }
+}
+
+void BitmapFont::rasterise(const Glyph &glyph, screen::Color color, screen::Color *out, size_t stride) const {
+
+    const size_t rowBytes = BitmapFont::stride(glyph.width);
+    const uint8_t *src = &m_atlas[glyph.offset];
+
+    for (size_t row = 0; row < m_height; row++) {
+        for (size_t col = 0; col < glyph.width; col += screen::glyph::RowPixels) {
+            const screen::glyph::RowMask &mask = screen::glyph::RowMasks[src[col / screen::glyph::RowPixels]];
+            const size_t n = std::min<size_t>(screen::glyph::RowPixels, glyph.width - col);
+            for (size_t i = 0; i < n; i++) {
+                out[col + i] = screen::glyph::blend(color, out[col + i], mask[i]);
+            }
+        }
+        src += rowBytes;
+        out += stride;
+    }
+}
+
+void BitmapFont::rasterise(const Glyph &glyph, const screen::glyph::Ramp &ramp, screen::Color *out, size_t stride) const {
+
+    const size_t rowBytes = BitmapFont::stride(glyph.width);
+    const uint8_t *src = &m_atlas[glyph.offset];
+    const uint8_t mask = static_cast<uint8_t>((1u << m_bitsPerPixel) - 1);
+    const size_t scale = (screen::glyph::RampLevels - 1) / mask;
+
+    for (size_t row = 0; row < m_height; row++) {
+        for (size_t col = 0; col < glyph.width; col++) {
+            const size_t bit = col * m_bitsPerPixel;
+            const uint8_t level = (src[bit / 8] >> (bit % 8)) & mask;
+            if (level) {
+                out[col] = ramp[level * scale];
+            }
+        }
+        src += rowBytes;
+        out += stride;
+    }
+}
+
+void BitmapFont::clear(uint8_t height, uint8_t bitsPerPixel) {
+
+    m_height = height;
+    m_bitsPerPixel = bitsPerPixel;
+    m_id = nextFontId.fetch_add(1, std::memory_order_relaxed);
+    m_atlas.clear();
+    m_glyphs.clear();
+    m_index.clear();
+    m_direct.fill(screen::fonts::NoGlyph);
+}
+
+uint32_t BitmapFont::addGlyph(uint8_t width, uint8_t advance) {
+
+    m_glyphs.push_back({static_cast<uint32_t>(m_atlas.size()), width, advance});
+    m_atlas.resize(m_atlas.size() + stride(width) * m_height, 0);
+    return static_cast<uint32_t>(m_glyphs.size() - 1);
+}
+
+void BitmapFont::setPixel(const Glyph &glyph, size_t row, size_t col) {
+
+    m_atlas[glyph.offset + row * stride(glyph.width) + col / 8] |= static_cast<uint8_t>(1u << (col % 8));
+}
+
+void BitmapFont::setLevel(const Glyph &glyph, size_t row, size_t col, uint8_t level) {
+
+    const size_t bit = col * m_bitsPerPixel;
+    m_atlas[glyph.offset + row * stride(glyph.width) + bit / 8] |= static_cast<uint8_t>(level << (bit % 8));
+}
+
+uint32_t BitmapFont::glyphIndex(uint32_t codepoint) const {
+
+    const Glyph *glyph = find(codepoint);
+    if (!glyph) {
+        glyph = find(screen::fonts::FallbackCodepoint);
+    }
+    return glyph ? static_cast<uint32_t>(glyph - m_glyphs.data()) : 0;
+}
+
+void BitmapFont::map(uint32_t codepoint, uint32_t glyphIndex) {
+
+    if (codepoint < screen::fonts::DirectCodepoints) {
+        m_direct[codepoint] = glyphIndex;
+    } else {
+        m_index.emplace(codepoint, glyphIndex);
+    }
+}
+
+size_t BitmapFont::stride(uint8_t width) const {
+
+    return (static_cast<size_t>(width) * m_bitsPerPixel + 7) / 8;
+}
@@ -0,0 +1,288 @@
+#include <cstdint>   // uint
+#include <cmath>     // sqrt, ceil, sin, cos, hypot
+#include <cstdlib>   // abs
+#include <algorithm> // min, max, fill_n, sort, swap
+#include <numbers>   // pi
+#include <span>      // span
+#include <vector>    // vector
+
+#include "screen_constants.h"
+#include "canvas.h"
+
+namespace {
+
+    // Largest integer whose square is at most value
+    int isqrt(int value) {
+
+        if (value <= 0) {
+            return 0;
+        }
+        int root = static_cast<int>(std::sqrt(static_cast<double>(value)));
+        while (root * root > value) {
+            root--;
+        }
+        while ((root + 1) * (root + 1) <= value) {
+            root++;
+        }
+        return root;
+    }
+
+    // Half width of row dy of a circle of radius r, r * r + r keeps small circles round
+    int circleSpan(int r, int dy) {
+
+        return isqrt(r * r + r - dy * dy);
+    }
+}
+
+Canvas::Canvas(uint8_t width, uint8_t height, screen::Color background)
+    : m_width(width), m_height(height), m_pixels(static_cast<size_t>(width) * height, background) {
+}
+
+uint8_t Canvas::width() const {
+
+    return m_width;
+}
+
+uint8_t Canvas::height() const {
+
+    return m_height;
+}
+
+const std::vector<screen::Color> &Canvas::pixels() const {
+
+    return m_pixels;
+}
+
+screen::Color Canvas::pixel(int x, int y) const {
+
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return screen::StandardColor::Black;
+    }
+    return m_pixels[y * m_width + x];
+}
+
+void Canvas::clear(screen::Color color) {
+
+    std::fill(m_pixels.begin(), m_pixels.end(), color);
+}
+
+void Canvas::fillSpan(int x1, int x2, int y, screen::Color color) {
+
+    if (y < 0 || y >= m_height) {
+        return;
+    }
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+    x1 = std::max(x1, 0);
+    x2 = std::min(x2, m_width - 1);
+    if (x1 > x2) {
+        return;
+    }
+
+    std::fill_n(&m_pixels[y * m_width + x1], x2 - x1 + 1, color);
+}
+
+void Canvas::setPixel(int x, int y, screen::Color color) {
+
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return;
+    }
+    m_pixels[y * m_width + x] = color;
+}
+
+void Canvas::drawLine(int x1, int y1, int x2, int y2, screen::Color color) {
+
+    if (y1 == y2) {
+        fillSpan(x1, x2, y1, color);
+        return;
+    }
+
+    // Bresenham
+    const int dx = std::abs(x2 - x1);
+    const int dy = -std::abs(y2 - y1);
+    const int sx = (x1 < x2) ? 1 : -1;
+    const int sy = (y1 < y2) ? 1 : -1;
+    int error = dx + dy;
+
+    while (true) {
+        setPixel(x1, y1, color);
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        const int e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void Canvas::drawThickLine(int x1, int y1, int x2, int y2, uint8_t thickness, screen::Color color) {
+
+    if (thickness <= 1) {
+        drawLine(x1, y1, x2, y2, color);
+        return;
+    }
+
+    const float half = thickness / 2.0f;
+    const float ax = x1 + 0.5f;
+    const float ay = y1 + 0.5f;
+    const float length = std::hypot(static_cast<float>(x2 - x1), static_cast<float>(y2 - y1));
+
+    // Direction and normal, scaled to half the thickness
+    float ux = half;
+    float uy = 0.0f;
+    if (length > 0.0f) {
+        ux = (x2 - x1) / length * half;
+        uy = (y2 - y1) / length * half;
+    }
+    const float bx = ax + (x2 - x1);
+    const float by = ay + (y2 - y1);
+
+    m_vertices.assign({
+        {ax - ux - uy, ay - uy + ux},
+        {bx + ux - uy, by + uy + ux},
+        {bx + ux + uy, by + uy - ux},
+        {ax - ux + uy, ay - uy - ux}
+    });
+    fillVertices(color);
+}
+
+void Canvas::fillRect(int x1, int y1, int x2, int y2, screen::Color color) {
+
+    if (y1 > y2) {
+        std::swap(y1, y2);
+    }
+    for (int y = std::max(y1, 0); y <= std::min(y2, m_height - 1); y++) {
+        fillSpan(x1, x2, y, color);
+    }
+}
+
+void Canvas::fillRoundedRect(int x1, int y1, int x2, int y2, uint8_t radius, screen::Color color) {
+
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+    if (y1 > y2) {
+        std::swap(y1, y2);
+    }
+
+    // The corners can not be larger than half the rectangle
+    const int r = std::min({static_cast<int>(radius), (x2 - x1) / 2, (y2 - y1) / 2});
+
+    for (int y = std::max(y1, 0); y <= std::min(y2, m_height - 1); y++) {
+        const int edge = std::min(y - y1, y2 - y);
+        const int inset = (edge < r) ? r - circleSpan(r, r - edge) : 0;
+        fillSpan(x1 + inset, x2 - inset, y, color);
+    }
+}
+
+void Canvas::fillCircle(int cx, int cy, int r, screen::Color color) {
+
+    if (r < 0) {
+        return;
+    }
+    for (int dy = -r; dy <= r; dy++) {
+        const int dx = circleSpan(r, dy);
+        fillSpan(cx - dx, cx + dx, cy + dy, color);
+    }
+}
+
+void Canvas::fillEllipse(int cx, int cy, int rx, int ry, screen::Color color) {
+
+    if (rx < 0 || ry < 0) {
+        return;
+    }
+
+    // Rows are sampled at their center against an ellipse half a pixel larger
+    const float ryOut = ry + 0.5f;
+    for (int dy = -ry; dy <= ry; dy++) {
+        const float t = 1.0f - (dy * dy) / (ryOut * ryOut);
+        const int dx = static_cast<int>(rx * std::sqrt(std::max(t, 0.0f)) + 0.5f);
+        fillSpan(cx - dx, cx + dx, cy + dy, color);
+    }
+}
+
+void Canvas::drawArc(int cx, int cy, int r, uint8_t thickness, float startDeg, float endDeg, screen::Color color) {
+
+    if (r < 0 || thickness == 0 || endDeg <= startDeg) {
+        return;
+    }
+
+    const float sweep = std::min(endDeg - startDeg, 360.0f);
+    const float outer = r + 0.5f;
+    const float inner = std::max(outer - thickness, 0.0f);
+    const float x0 = cx + 0.5f;
+    const float y0 = cy + 0.5f;
+
+    const float rad = std::numbers::pi_v<float> / 180.0f;
+    const int steps = std::max(2, static_cast<int>(std::ceil(sweep * rad * outer / screen::canvas::ArcStep)));
+
+    // Outer edge forwards, inner edge backwards. A full ring goes back over the same
+    // segment between both edges, which cancels out with the even-odd rule.
+    m_vertices.clear();
+    for (int i = 0; i <= steps; i++) {
+        const float a = (startDeg + sweep * i / steps) * rad;
+        m_vertices.push_back({x0 + outer * std::sin(a), y0 - outer * std::cos(a)});
+    }
+    for (int i = steps; i >= 0; i--) {
+        const float a = (startDeg + sweep * i / steps) * rad;
+        m_vertices.push_back({x0 + inner * std::sin(a), y0 - inner * std::cos(a)});
+    }
+    fillVertices(color);
+}
+
+void Canvas::fillPolygon(std::span<const screen::canvas::Point> points, screen::Color color) {
+
+    m_vertices.clear();
+    for (const screen::canvas::Point &p : points) {
+        m_vertices.push_back({static_cast<float>(p.x), static_cast<float>(p.y)});
+    }
+    fillVertices(color);
+}
+
+void Canvas::fillVertices(screen::Color color) {
+
+    const size_t n = m_vertices.size();
+    if (n < 3) {
+        return;
+    }
+
+    float top = m_vertices[0].y;
+    float bottom = m_vertices[0].y;
+    for (const Vertex &v : m_vertices) {
+        top = std::min(top, v.y);
+        bottom = std::max(bottom, v.y);
+    }
+
+    // Pixels whose center is inside: rows and columns with center in [a, b)
+    const int firstRow = std::max(0, static_cast<int>(std::ceil(top - 0.5f)));
+    const int lastRow = std::min(m_height - 1, static_cast<int>(std::ceil(bottom - 0.5f)) - 1);
+
+    for (int y = firstRow; y <= lastRow; y++) {
+        const float sy = y + 0.5f;
+
+        m_crossings.clear();
+        for (size_t i = 0; i < n; i++) {
+            const Vertex &a = m_vertices[i];
+            const Vertex &b = m_vertices[(i + 1) % n];
+            if ((a.y <= sy && b.y > sy) || (b.y <= sy && a.y > sy)) {
+                m_crossings.push_back(a.x + (sy - a.y) * (b.x - a.x) / (b.y - a.y));
+            }
+        }
+        std::sort(m_crossings.begin(), m_crossings.end());
+
+        for (size_t i = 0; i + 1 < m_crossings.size(); i += 2) {
+            const int x1 = static_cast<int>(std::ceil(m_crossings[i] - 0.5f));
+            const int x2 = static_cast<int>(std::ceil(m_crossings[i + 1] - 0.5f)) - 1;
+            if (x1 <= x2) {
+                fillSpan(x1, x2, y, color);
+            }
+        }
+    }
+}
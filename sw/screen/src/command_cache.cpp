@@ -0,0 +1,156 @@
+#include <cstdint>   // uint
+#include <algorithm> // equal, copy
+
+#include "screen_constants.h"
+#include "pixel_encoding.h"
+#include "command_cache.h"
+
+namespace {
+
+    template <size_t N>
+    bool matches(const std::optional<std::array<uint8_t, N>> &state, std::span<const uint8_t> params) {
+
+        return state && params.size() == N && std::equal(params.begin(), params.end(), state->begin());
+    }
+
+    bool matches(const std::optional<uint8_t> &state, std::span<const uint8_t> params) {
+
+        return state && params.size() == 1 && params[0] == *state;
+    }
+
+    template <size_t N>
+    std::optional<std::array<uint8_t, N>> fromParams(std::span<const uint8_t> params) {
+
+        if (params.size() != N) {
+            return std::nullopt;
+        }
+        std::array<uint8_t, N> value;
+        std::copy(params.begin(), params.end(), value.begin());
+        return value;
+    }
+
+    std::optional<uint8_t> fromParams(std::span<const uint8_t> params) {
+
+        if (params.size() != 1) {
+            return std::nullopt;
+        }
+        return params[0];
+    }
+
+    size_t bytesPerPixel(uint8_t remap) {
+
+        switch (static_cast<screen::RemapColorDepth::ColorDepth>((remap & screen::RemapColorDepth::ColorDepth_Msk) >> screen::RemapColorDepth::ColorDepth_Pos)) {
+            case screen::RemapColorDepth::ColorDepth::Color256:
+                return screen::encoding::Color256::Bytes;
+            case screen::RemapColorDepth::ColorDepth::Color65k:
+                return screen::encoding::Color65k::Bytes;
+            default:
+                return screen::encoding::Color65kAlt::Bytes;
+        }
+    }
+}
+
+bool CommandCache::isRedundant(screen::Command cmd, std::span<const uint8_t> params) const {
+
+    switch (cmd) {
+        case screen::Command::ColumnAddress:
+            return matches(m_columns, params) && isPointerAtStart();
+        case screen::Command::RowAddress:
+            return matches(m_rows, params) && isPointerAtStart();
+        case screen::Command::RemapColorDepth:
+            return matches(m_remap, params);
+        case screen::Command::FillEnable:
+            return matches(m_fill, params);
+        case screen::Command::ContinuousScrolling:
+            return matches(m_scrollSetup, params);
+        case screen::Command::ActivateScroll:
+            return m_scrolling && *m_scrolling;
+        case screen::Command::DeactivateScroll:
+            return m_scrolling && !*m_scrolling;
+        default:
+            return false;
+    }
+}
+
+void CommandCache::commit(screen::Command cmd, std::span<const uint8_t> params) {
+
+    switch (cmd) {
+        case screen::Command::ColumnAddress:
+            settlePointer();
+            m_columns = fromParams<2>(params);
+            m_columnAtStart = true;
+            break;
+        case screen::Command::RowAddress:
+            settlePointer();
+            m_rows = fromParams<2>(params);
+            m_rowAtStart = true;
+            break;
+        case screen::Command::RemapColorDepth:
+            settlePointer();
+            m_remap = fromParams(params);
+            break;
+        case screen::Command::FillEnable:
+            m_fill = fromParams(params);
+            break;
+        case screen::Command::ContinuousScrolling:
+            m_scrollSetup = fromParams<5>(params);
+            break;
+        case screen::Command::ActivateScroll:
+            m_scrolling = true;
+            break;
+        case screen::Command::DeactivateScroll:
+            m_scrolling = false;
+            break;
+        case screen::Command::DrawLine:
+        case screen::Command::DrawRectangle:
+        case screen::Command::Copy:
+        case screen::Command::DimWindow:
+        case screen::Command::ClearWindow:
+            // The datasheet does not say where the drawing engine leaves the RAM pointer
+            m_columnAtStart = false;
+            m_rowAtStart = false;
+            m_windowData = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+void CommandCache::addData(uint64_t bytes) {
+
+    m_windowData += bytes;
+}
+
+void CommandCache::invalidate() {
+
+    *this = CommandCache{};
+}
+
+bool CommandCache::isPointerAtStart() const {
+
+    if (!m_columnAtStart || !m_rowAtStart) {
+        return false;
+    }
+    if (m_windowData == 0) {
+        return true;
+    }
+    if (!m_columns || !m_rows || !m_remap || (*m_columns)[1] < (*m_columns)[0] || (*m_rows)[1] < (*m_rows)[0]) {
+        return false;
+    }
+
+    // The pointer wraps around the window, so whole windows of data leave it where it started
+    const uint64_t windowBytes = static_cast<uint64_t>((*m_columns)[1] - (*m_columns)[0] + 1) * ((*m_rows)[1] - (*m_rows)[0] + 1) * bytesPerPixel(*m_remap);
+    return m_windowData % windowBytes == 0;
+}
+
+void CommandCache::settlePointer() {
+
+    if (m_windowData == 0) {
+        return;
+    }
+
+    const bool atStart = isPointerAtStart();
+    m_columnAtStart = atStart;
+    m_rowAtStart = atStart;
+    m_windowData = 0;
+}
@@ -0,0 +1,104 @@
+#include <cstdint> // uint
+#include <span>    // span
+#include <vector>  // vector
+
+#include "screen_constants.h"
+#include "canvas.h"
+#include "compositor.h"
+
+namespace {
+
+    bool sameColor(screen::Color a, screen::Color b) {
+
+        return a.r == b.r && a.g == b.g && a.b == b.b;
+    }
+}
+
+Compositor::Compositor(uint8_t width, uint8_t height, size_t layers, screen::Color background)
+    : m_background(background), m_composite(width, height, background) {
+
+    m_layers.reserve(layers);
+    for (size_t i = 0; i < layers; i++) {
+        m_layers.emplace_back(width, height, (i == 0) ? background : screen::compositor::Transparent);
+    }
+}
+
+uint8_t Compositor::width() const {
+
+    return m_composite.width();
+}
+
+uint8_t Compositor::height() const {
+
+    return m_composite.height();
+}
+
+size_t Compositor::layerCount() const {
+
+    return m_layers.size();
+}
+
+Canvas &Compositor::layer(size_t index) {
+
+    return m_layers.at(index);
+}
+
+void Compositor::clearLayer(size_t index) {
+
+    m_layers.at(index).clear((index == 0) ? m_background : screen::compositor::Transparent);
+}
+
+std::span<const screen::canvas::Span> Compositor::compose() {
+
+    const int w = width();
+    const int h = height();
+
+    m_damage.clear();
+
+    for (int y = 0; y < h; y++) {
+        int first = -1; // First changed pixel of the pending span
+        int last = -1;
+
+        for (int x = 0; x < w; x++) {
+            // Top-most opaque pixel
+            screen::Color color = m_background;
+            for (size_t i = m_layers.size(); i-- > 0;) {
+                const screen::Color c = m_layers[i].pixel(x, y);
+                if (i == 0 || !sameColor(c, screen::compositor::Transparent)) {
+                    color = c;
+                    break;
+                }
+            }
+            if (m_valid && sameColor(color, m_composite.pixel(x, y))) {
+                continue;
+            }
+            m_composite.setPixel(x, y, color);
+
+            if (first >= 0 && x - last - 1 > screen::compositor::MergeGap) {
+                m_damage.push_back({static_cast<uint8_t>(y), static_cast<uint8_t>(first), static_cast<uint8_t>(last)});
+                first = -1;
+            }
+            if (first < 0) {
+                first = x;
+            }
+            last = x;
+        }
+
+        if (first >= 0) {
+            m_damage.push_back({static_cast<uint8_t>(y), static_cast<uint8_t>(first), static_cast<uint8_t>(last)});
+        }
+    }
+
+    m_valid = true;
+    return m_damage;
+}
+
+const Canvas &Compositor::composite() const {
+
+    return m_composite;
+}
+
+void Compositor::invalidate() {
+
+    m_valid = false;
+}
@@ -0,0 +1,436 @@
+#include <iostream>  // cerr, endl
+#include <fstream>   // ofstream
+#include <cstdlib>   // getenv, abs
+#include <algorithm> // min, max, fill
+
+#include "screen_constants.h"
+#include "screen_registers.h"
+#include "emulator.h"
+
+Emulator::Emulator(const std::string &device) : m_device(device) {
+}
+
+Emulator::~Emulator() {
+
+    const char *dir = std::getenv(screen::emulator::DumpDirEnv);
+    if (dir) {
+        savePpm(std::string(dir) + "/" + m_device + ".ppm");
+    }
+}
+
+bool Emulator::isEmulated(const std::string &device) {
+
+#ifdef SCREEN_EMULATOR
+    (void)device;
+    return true;
+#else
+    return device.starts_with(screen::emulator::DevicePrefix);
+#endif
+}
+
+void Emulator::writeRegister(size_t reg, uint32_t value) {
+
+    switch (reg) {
+        case screen::reg::POWER_CTRL:
+            // Transitions complete instantly, so a change of ON_OFF is the end of one
+            if ((value ^ m_powerCtrl) & screen::mask::ON_OFF) {
+                m_irqStatus |= screen::mask::IRQ_POWER;
+            }
+            m_powerCtrl = value;
+            break;
+        case screen::reg::SPI_CTRL:
+            if ((value & screen::mask::SPI_TRIGGER) && pushTxEntry()) {
+                receiveByte(static_cast<uint8_t>((value & screen::mask::BYTE) >> screen::bit::BYTE),
+                            static_cast<screen::DataMode>((value & screen::mask::DC_SELECT) >> screen::bit::DC_SELECT));
+            }
+            break;
+        case screen::reg::SPI_BURST: {
+            if (!pushTxEntry()) {
+                break;
+            }
+            const uint32_t count = ((m_burstCtrl & screen::mask::BURST_COUNT) >> screen::bit::BURST_COUNT) + 1;
+            const uint32_t dc = (m_burstCtrl & screen::mask::BURST_DC) >> screen::bit::BURST_DC;
+            for (uint32_t b = 0; b < count; b++) {
+                receiveByte(static_cast<uint8_t>(value >> (8 * b)), static_cast<screen::DataMode>((dc >> b) & 1));
+            }
+            break;
+        }
+        case screen::reg::SPI_STATUS:
+            if (value & screen::mask::FIFO_OVERFLOW) {
+                m_txOverflow = false;
+            }
+            break;
+        case screen::reg::SPI_BURST_CTRL:
+            m_burstCtrl = value;
+            break;
+        case screen::reg::SPI_CLK_DIV:
+            m_clockDivider = (value & screen::mask::CLK_DIV) >> screen::bit::CLK_DIV;
+            break;
+        case screen::reg::IRQ_ENABLE:
+            m_irqEnable = value & screen::mask::IRQ_SOURCES;
+            break;
+        case screen::reg::IRQ_STATUS:
+            m_irqStatus &= ~value;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t Emulator::readRegister(size_t reg) const {
+
+    switch (reg) {
+        case screen::reg::POWER_CTRL:
+            return m_powerCtrl;
+        case screen::reg::POWER_STATUS:
+            // Power transitions complete instantly
+            return (m_powerCtrl & screen::mask::ON_OFF) ? static_cast<uint32_t>(screen::PowerState::On) : static_cast<uint32_t>(screen::PowerState::Off);
+        case screen::reg::SPI_STATUS: {
+            // Bytes reach the panel when they are written, the queue only holds their slots
+            const uint32_t level = m_txLevel - std::min({m_txLevel, m_txPosted, screen::emulator::TxFifoLevelLag});
+            m_txPosted = 0;
+            m_txLevel -= std::min(m_txLevel, screen::emulator::TxFifoDrainPerRead);
+
+            uint32_t status = level << screen::bit::FIFO_LEVEL;
+            if (level == 0) {
+                status |= screen::mask::SPI_READY | screen::mask::FIFO_EMPTY;
+            }
+            if (level == screen::emulator::TxFifoDepth) {
+                status |= screen::mask::FIFO_FULL;
+            }
+            if (m_txOverflow) {
+                status |= screen::mask::FIFO_OVERFLOW;
+            }
+            return status;
+        }
+        case screen::reg::SPI_BURST_CTRL:
+            return m_burstCtrl;
+        case screen::reg::IP_INFO:
+            return (screen::emulator::TxFifoDepth << screen::bit::FIFO_DEPTH) | screen::mask::STREAM | screen::mask::IRQ;
+        case screen::reg::SPI_CLK_DIV:
+            return (m_clockDivider << screen::bit::CLK_DIV) | (screen::spi::SpecClockDivider << screen::bit::CLK_DIV_DEFAULT);
+        case screen::reg::IRQ_ENABLE:
+            return m_irqEnable;
+        case screen::reg::IRQ_STATUS:
+            return m_irqStatus;
+        default:
+            return 0;
+    }
+}
+
+void Emulator::receiveStream(const uint8_t *data, size_t length) {
+
+    for (size_t i = 0; i < length; i++) {
+        receiveByte(data[i], screen::DataMode::Data);
+    }
+}
+
+const std::array<uint16_t, screen::Geometry::Pixels> &Emulator::frame() const {
+
+    return m_frame;
+}
+
+uint64_t Emulator::bytesReceived() const {
+
+    return m_bytes;
+}
+
+std::chrono::nanoseconds Emulator::wireTime() const {
+
+    return std::chrono::nanoseconds(m_wireNs);
+}
+
+bool Emulator::savePpm(const std::string &path) const {
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << static_cast<int>(screen::Geometry::Columns) << " " << static_cast<int>(screen::Geometry::Rows) << "\n255\n";
+
+    for (uint16_t c : m_frame) {
+        const uint8_t r5 = (c >> 11) & 0x1F;
+        const uint8_t g6 = (c >> 5) & 0x3F;
+        const uint8_t b5 = c & 0x1F;
+        const char rgb[3] = {
+            static_cast<char>((r5 << 3) | (r5 >> 2)),
+            static_cast<char>((g6 << 2) | (g6 >> 4)),
+            static_cast<char>((b5 << 3) | (b5 >> 2))
+        };
+        file.write(rgb, 3);
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool Emulator::pushTxEntry() {
+
+    if (m_txLevel == screen::emulator::TxFifoDepth) {
+        m_txOverflow = true;
+        return false;
+    }
+    m_txLevel++;
+    m_txPosted++;
+    return true;
+}
+
+void Emulator::receiveByte(uint8_t byte, screen::DataMode mode) {
+
+    const uint32_t divider = m_clockDivider ? m_clockDivider : screen::spi::SpecClockDivider;
+
+    // 8 SCK cycles of 2 * divider IP clocks, after which the queue is idle again
+    m_bytes++;
+    m_irqStatus |= screen::mask::IRQ_TX_IDLE;
+    m_wireNs += 16ull * divider * 1000000000ull / screen::spi::ClockHz;
+
+    // Bytes clocked faster than the SSD1331 allows are missed, nothing tells how far a real panel goes
+    if (!(m_powerCtrl & screen::mask::ON_OFF) || divider < screen::spi::SpecClockDivider) {
+        return;
+    }
+
+    if (mode == screen::DataMode::Command) {
+        receiveCommandByte(byte);
+    } else {
+        receiveDataByte(byte);
+    }
+}
+
+void Emulator::receiveCommandByte(uint8_t byte) {
+
+    // Parameters are sent in command mode too
+    if (m_paramsReceived < m_paramsExpected) {
+        m_params[m_paramsReceived++] = byte;
+        if (m_paramsReceived == m_paramsExpected) {
+            executeCommand();
+        }
+        return;
+    }
+
+    m_command = byte;
+    m_paramsExpected = paramCount(byte);
+    m_paramsReceived = 0;
+
+    if (m_paramsExpected == 0) {
+        executeCommand();
+    }
+}
+
+void Emulator::receiveDataByte(uint8_t byte) {
+
+    const uint8_t depth = (m_remap & screen::RemapColorDepth::ColorDepth_Msk) >> screen::RemapColorDepth::ColorDepth_Pos;
+
+    m_pixelBytes[m_pixelBytesReceived++] = byte;
+
+    switch (static_cast<screen::RemapColorDepth::ColorDepth>(depth)) {
+        case screen::RemapColorDepth::ColorDepth::Color256: {
+            // RRRGGGBB
+            const uint8_t b = m_pixelBytes[0];
+            writePixel(static_cast<uint16_t>(((b >> 5) & 0x07) << 13 | ((b >> 2) & 0x07) << 8 | (b & 0x03) << 3));
+            m_pixelBytesReceived = 0;
+            break;
+        }
+        case screen::RemapColorDepth::ColorDepth::Color65k: {
+            if (m_pixelBytesReceived == 2) {
+                writePixel(static_cast<uint16_t>(m_pixelBytes[0] << 8 | m_pixelBytes[1]));
+                m_pixelBytesReceived = 0;
+            }
+            break;
+        }
+        case screen::RemapColorDepth::ColorDepth::Color65kAlt: {
+            if (m_pixelBytesReceived == 3) {
+                const uint16_t r = (m_pixelBytes[0] >> 1) & 0x1F;
+                const uint16_t g = m_pixelBytes[1] & 0x3F;
+                const uint16_t b = (m_pixelBytes[2] >> 1) & 0x1F;
+                writePixel(static_cast<uint16_t>(r << 11 | g << 5 | b));
+                m_pixelBytesReceived = 0;
+            }
+            break;
+        }
+        default:
+            m_pixelBytesReceived = 0;
+            break;
+    }
+}
+
+void Emulator::executeCommand() {
+
+    const uint8_t *p = m_params.data();
+
+    switch (static_cast<screen::Command>(m_command)) {
+        case screen::Command::ColumnAddress:
+            m_window.columnStart = p[0];
+            m_window.columnEnd = p[1];
+            m_column = p[0];
+            m_pixelBytesReceived = 0;
+            break;
+        case screen::Command::RowAddress:
+            m_window.rowStart = p[0];
+            m_window.rowEnd = p[1];
+            m_row = p[0];
+            m_pixelBytesReceived = 0;
+            break;
+        case screen::Command::RemapColorDepth:
+            m_remap = p[0];
+            m_pixelBytesReceived = 0;
+            break;
+        case screen::Command::FillEnable:
+            m_fill = p[0] & 0x01;
+            m_reverseCopy = p[0] & 0x10;
+            break;
+        case screen::Command::DrawLine:
+            drawLine(p[0], p[1], p[2], p[3], colorFromParams(&p[4]));
+            break;
+        case screen::Command::DrawRectangle:
+            drawRectangle(p[0], p[1], p[2], p[3], colorFromParams(&p[4]), colorFromParams(&p[7]));
+            break;
+        case screen::Command::Copy:
+            copy(p[0], p[1], p[2], p[3], p[4], p[5]);
+            break;
+        case screen::Command::ClearWindow:
+            for (int r = p[1]; r <= p[3]; r++) {
+                for (int c = p[0]; c <= p[2]; c++) {
+                    setPixel(c, r, 0);
+                }
+            }
+            break;
+        default:
+            // Panel configuration, display modes and scrolling do not change the display RAM
+            break;
+    }
+}
+
+void Emulator::writePixel(uint16_t color) {
+
+    setPixel(m_column, m_row, color);
+
+    const bool vertical = m_remap & screen::RemapColorDepth::AddressIncrement_Msk;
+
+    if (vertical) {
+        if (++m_row > m_window.rowEnd) {
+            m_row = m_window.rowStart;
+            if (++m_column > m_window.columnEnd) {
+                m_column = m_window.columnStart;
+            }
+        }
+    } else {
+        if (++m_column > m_window.columnEnd) {
+            m_column = m_window.columnStart;
+            if (++m_row > m_window.rowEnd) {
+                m_row = m_window.rowStart;
+            }
+        }
+    }
+}
+
+void Emulator::setPixel(int column, int row, uint16_t color) {
+
+    if (column < 0 || column >= screen::Geometry::Columns || row < 0 || row >= screen::Geometry::Rows) {
+        return;
+    }
+    m_frame[row * screen::Geometry::Columns + column] = color;
+}
+
+void Emulator::drawLine(int c1, int r1, int c2, int r2, uint16_t color) {
+
+    // Bresenham
+    const int dc = std::abs(c2 - c1);
+    const int dr = -std::abs(r2 - r1);
+    const int sc = (c1 < c2) ? 1 : -1;
+    const int sr = (r1 < r2) ? 1 : -1;
+    int error = dc + dr;
+
+    while (true) {
+        setPixel(c1, r1, color);
+        if (c1 == c2 && r1 == r2) {
+            break;
+        }
+        const int e2 = 2 * error;
+        if (e2 >= dr) {
+            error += dr;
+            c1 += sc;
+        }
+        if (e2 <= dc) {
+            error += dc;
+            r1 += sr;
+        }
+    }
+}
+
+void Emulator::drawRectangle(int c1, int r1, int c2, int r2, uint16_t line, uint16_t fill) {
+
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            const bool border = (r == r1 || r == r2 || c == c1 || c == c2);
+            if (border) {
+                setPixel(c, r, line);
+            } else if (m_fill) {
+                setPixel(c, r, fill);
+            }
+        }
+    }
+}
+
+void Emulator::copy(int c1, int r1, int c2, int r2, int c3, int r3) {
+
+    const std::array<uint16_t, screen::Geometry::Pixels> source = m_frame;
+
+    for (int r = r1; r <= r2; r++) {
+        for (int c = c1; c <= c2; c++) {
+            if (c < 0 || c >= screen::Geometry::Columns || r < 0 || r >= screen::Geometry::Rows) {
+                continue;
+            }
+            uint16_t color = source[r * screen::Geometry::Columns + c];
+            if (m_reverseCopy) {
+                color = ~color;
+            }
+            setPixel(c3 + (c - c1), r3 + (r - r1), color);
+        }
+    }
+}
+
+uint8_t Emulator::paramCount(uint8_t command) {
+
+    switch (static_cast<screen::Command>(command)) {
+        case screen::Command::ColumnAddress:         return 2;
+        case screen::Command::RowAddress:            return 2;
+        case screen::Command::ContrastA:             return 1;
+        case screen::Command::ContrastB:             return 1;
+        case screen::Command::ContrastC:             return 1;
+        case screen::Command::MasterCurrentControl:  return 1;
+        case screen::Command::SecondPrechargeSpeedA: return 1;
+        case screen::Command::SecondPrechargeSpeedB: return 1;
+        case screen::Command::SecondPrechargeSpeedC: return 1;
+        case screen::Command::RemapColorDepth:       return 1;
+        case screen::Command::DisplayStartLine:      return 1;
+        case screen::Command::DisplayOffset:         return 1;
+        case screen::Command::MuxRatio:              return 1;
+        case screen::Command::DimMode:               return 5;
+        case screen::Command::MasterConfiguration:   return 1;
+        case screen::Command::PowerSaveMode:         return 1;
+        case screen::Command::PhasePeriodAdjustment: return 1;
+        case screen::Command::DisplayClockDiv:       return 1;
+        case screen::Command::GrayScaleTable:        return 32;
+        case screen::Command::PreChargeLevel:        return 1;
+        case screen::Command::VCOMH:                 return 1;
+        case screen::Command::CommandLock:           return 1;
+        case screen::Command::DrawLine:              return 7;
+        case screen::Command::DrawRectangle:         return 10;
+        case screen::Command::Copy:                  return 6;
+        case screen::Command::DimWindow:             return 4;
+        case screen::Command::ClearWindow:           return 4;
+        case screen::Command::FillEnable:            return 1;
+        case screen::Command::ContinuousScrolling:   return 5;
+        default:                                     return 0;
+    }
+}
+
+uint16_t Emulator::colorFromParams(const uint8_t *params) {
+
+    // Colors are sent as 6 bit C, B, A (r << 1, g, b << 1)
+    const uint16_t r = (params[0] >> 1) & 0x1F;
+    const uint16_t g = params[1] & 0x3F;
+    const uint16_t b = (params[2] >> 1) & 0x1F;
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
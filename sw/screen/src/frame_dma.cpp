@@ -0,0 +1,240 @@
+#include <cstring>    // strerror
+#include <cerrno>     // errno
+#include <stdexcept>  // runtime_error
+#include <fstream>    // ifstream
+#include <thread>     // sleep_for
+#include <atomic>     // atomic_thread_fence
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, read, write, getpagesize
+#include <poll.h>     // poll
+#include <sys/mman.h> // mmap, munmap
+
+#include "screen_metrics.h"
+#include "frame_dma.h"
+
+FrameDma::FrameDma(const std::string &dma_device, Emulator *emulator) {
+
+    if (Emulator::isEmulated(dma_device)) {
+        if (!emulator) {
+            throw std::runtime_error("Emulated DMA " + dma_device + " needs an emulated screen");
+        }
+        m_emulator = emulator;
+        m_emulatedBuffer.resize(screen::dma::EmulatedBufferBytes);
+        m_buffer = m_emulatedBuffer.data();
+        m_size = m_emulatedBuffer.size();
+        return;
+    }
+
+    // Physical address first, a buffer the DMA cannot be pointed at is of no use
+    const uint64_t physAddr = readBufferAttribute(dma_device, "addr");
+    m_size = static_cast<size_t>(readBufferAttribute(dma_device, "size"));
+    if (physAddr > UINT32_MAX - m_size) {
+        throw std::runtime_error("Buffer of " + dma_device + " is out of the 32 bit range of the DMA");
+    }
+    m_physAddr = static_cast<uint32_t>(physAddr);
+
+    const std::string path = "/dev/" + dma_device;
+    m_fd = open(path.c_str(), O_RDWR | O_SYNC);
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    void *reg = mmap(nullptr, screen::dma::MapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (reg == MAP_FAILED) {
+        const std::string error = std::strerror(errno);
+        release();
+        throw std::runtime_error("mmap failed for " + path + ": " + error);
+    }
+    m_reg = reinterpret_cast<volatile uint32_t *>(reg);
+
+    // UIO selects map N with an offset of N pages and maps it uncached, so the DMA reads what the CPU wrote without
+    // cache maintenance
+    const off_t bufferOffset = static_cast<off_t>(screen::dma::BufferMap * static_cast<size_t>(getpagesize()));
+    void *buffer = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, bufferOffset);
+    if (buffer == MAP_FAILED) {
+        const std::string error = std::strerror(errno);
+        release();
+        throw std::runtime_error("mmap failed for the buffer of " + path + ": " + error);
+    }
+    m_buffer = static_cast<uint8_t *>(buffer);
+
+    if (!reset()) {
+        release();
+        throw std::runtime_error("DMA " + dma_device + " did not come out of reset");
+    }
+
+    // Fails when the device tree gives the DMA no interrupt, the waits then poll
+    m_interrupt = enableInterrupt();
+}
+
+FrameDma::~FrameDma() {
+
+    if (m_busy) {
+        wait();
+    }
+    release();
+}
+
+uint8_t *FrameDma::buffer() {
+
+    return m_buffer;
+}
+
+size_t FrameDma::capacity() const {
+
+    return m_size;
+}
+
+bool FrameDma::start(size_t length) {
+
+    if (length == 0 || length > m_size) {
+        return false;
+    }
+
+    if (m_emulator) {
+        m_emulator->receiveStream(m_buffer, length);
+        return true;
+    }
+
+    if (m_busy && !wait()) {
+        return false;
+    }
+
+    if (readRegister(screen::dma::MM2S_DMASR) & screen::dma::DMASR_HALTED) {
+        return false;
+    }
+
+    // The buffer writes land before the DMA is told to read them
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    writeRegister(screen::dma::MM2S_SA, m_physAddr);
+    writeRegister(screen::dma::MM2S_LENGTH, static_cast<uint32_t>(length));
+    m_busy = true;
+    return true;
+}
+
+bool FrameDma::wait(std::chrono::milliseconds timeout) {
+
+    if (!m_busy) {
+        return true;
+    }
+
+    const uint64_t end = screen::metrics::nowNs() + static_cast<uint64_t>(std::chrono::nanoseconds(timeout).count());
+
+    while (true) {
+        const uint32_t status = readRegister(screen::dma::MM2S_DMASR);
+
+        if (status & screen::dma::DMASR_ERRORS) {
+            break;
+        }
+        if (status & screen::dma::DMASR_IDLE) {
+            // Acknowledged before the interrupt is enabled again, the line is level triggered
+            writeRegister(screen::dma::MM2S_DMASR, screen::dma::DMASR_IOC_IRQ);
+            m_busy = false;
+            return true;
+        }
+
+        const uint64_t now = screen::metrics::nowNs();
+        if (now >= end) {
+            break;
+        }
+
+        if (m_interrupt) {
+            pollfd pfd = {m_fd, POLLIN, 0};
+            const int remainingMs = static_cast<int>((end - now) / 1000000 + 1);
+            if (poll(&pfd, 1, remainingMs) > 0) {
+                // Interrupt count, only its arrival matters
+                uint32_t count = 0;
+                if (read(m_fd, &count, sizeof(count)) == sizeof(count)) {
+                    writeRegister(screen::dma::MM2S_DMASR, screen::dma::DMASR_IOC_IRQ | screen::dma::DMASR_ERR_IRQ);
+                    enableInterrupt();
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(screen::dma::PollInterval);
+        }
+    }
+
+    // The channel halts on an error, and a timed out transfer would still read the buffer
+    m_busy = false;
+    reset();
+    return false;
+}
+
+bool FrameDma::isBusy() const {
+
+    if (!m_busy) {
+        return false;
+    }
+    return !(readRegister(screen::dma::MM2S_DMASR) & (screen::dma::DMASR_IDLE | screen::dma::DMASR_ERRORS));
+}
+
+bool FrameDma::hasInterrupt() const {
+
+    return m_interrupt;
+}
+
+void FrameDma::writeRegister(size_t reg, uint32_t value) {
+
+    m_reg[reg] = value;
+}
+
+uint32_t FrameDma::readRegister(size_t reg) const {
+
+    return m_reg[reg];
+}
+
+bool FrameDma::reset() {
+
+    writeRegister(screen::dma::MM2S_DMACR, screen::dma::DMACR_RESET);
+    for (uint32_t i = 0; readRegister(screen::dma::MM2S_DMACR) & screen::dma::DMACR_RESET; i++) {
+        if (i == screen::dma::ResetPolls) {
+            return false;
+        }
+    }
+
+    writeRegister(screen::dma::MM2S_DMACR, screen::dma::DMACR_RS | screen::dma::DMACR_IOC_IRQ_EN | screen::dma::DMACR_ERR_IRQ_EN);
+    return !(readRegister(screen::dma::MM2S_DMASR) & screen::dma::DMASR_HALTED);
+}
+
+bool FrameDma::enableInterrupt() {
+
+    const uint32_t enable = 1;
+    return write(m_fd, &enable, sizeof(enable)) == sizeof(enable);
+}
+
+void FrameDma::release() {
+
+    if (m_buffer && !m_emulator) {
+        munmap(m_buffer, m_size);
+    }
+    m_buffer = nullptr;
+
+    if (m_reg) {
+        munmap((void*)m_reg, screen::dma::MapSize);
+        m_reg = nullptr;
+    }
+
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+uint64_t FrameDma::readBufferAttribute(const std::string &dma_device, const std::string &attribute) {
+
+    const std::string path = std::string(screen::dma::UioSysfsDir) + dma_device + "/maps/map" + std::to_string(screen::dma::BufferMap) + "/" + attribute;
+    std::ifstream file(path);
+    std::string value;
+
+    if (!(file >> value)) {
+        throw std::runtime_error("Failed to read " + path);
+    }
+
+    // Both are written in hex with 0x
+    try {
+        return std::stoull(value, nullptr, 0);
+    } catch (const std::exception &) {
+        throw std::runtime_error("Invalid value in " + path + ": " + value);
+    }
+}
@@ -0,0 +1,89 @@
+#include <cstdint>    // uint
+#include <functional> // hash
+#include <vector>     // vector
+#include <utility>    // move
+
+#include "screen_constants.h"
+#include "glyph_masks.h"
+#include "pixel_encoding.h"
+#include "bitmap_font.h"
+#include "glyph_cache.h"
+
+namespace {
+
+    uint64_t packColors(screen::Color color, screen::Color background) {
+
+        return static_cast<uint64_t>(color.r) << 40 | static_cast<uint64_t>(color.g) << 32 | static_cast<uint64_t>(color.b) << 24 |
+               static_cast<uint64_t>(background.r) << 16 | static_cast<uint64_t>(background.g) << 8 | background.b;
+    }
+
+    template <typename Encoding>
+    void encode(const std::vector<screen::Color> &pixels, std::vector<uint8_t> &out) {
+
+        out.resize(pixels.size() * Encoding::Bytes);
+        screen::encoding::packPixels<Encoding>(pixels.data(), pixels.size(), out.data());
+    }
+}
+
+size_t GlyphCache::KeyHash::operator()(const Key &key) const {
+
+    const std::hash<uint64_t> hash;
+    size_t h = hash(key.font);
+    h ^= hash(key.colors) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    h ^= hash(static_cast<uint64_t>(key.glyph) << 8 | key.depth) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+    return h;
+}
+
+std::span<const uint8_t> GlyphCache::get(const BitmapFont &font, uint32_t index, screen::Color color, screen::Color background,
+                                         screen::RemapColorDepth::ColorDepth depth, bool &hit) {
+
+    const Key key{font.id(), packColors(color, background), index, static_cast<uint8_t>(depth)};
+
+    auto it = m_glyphs.find(key);
+    hit = (it != m_glyphs.end());
+    if (hit) {
+        return it->second;
+    }
+
+    // Blend the glyph over its background, then encode it once
+    const BitmapFont::Glyph &glyph = font.glyph(index);
+    m_pixels.assign(static_cast<size_t>(glyph.width) * font.height(), background);
+    if (font.bitsPerPixel() == 1) {
+        font.rasterise(glyph, color, m_pixels.data(), glyph.width);
+    } else {
+        font.rasterise(glyph, screen::glyph::makeRamp(color, background), m_pixels.data(), glyph.width);
+    }
+
+    std::vector<uint8_t> encoded;
+    switch (depth) {
+        case screen::RemapColorDepth::ColorDepth::Color256:
+            encode<screen::encoding::Color256>(m_pixels, encoded);
+            break;
+        case screen::RemapColorDepth::ColorDepth::Color65k:
+            encode<screen::encoding::Color65k>(m_pixels, encoded);
+            break;
+        case screen::RemapColorDepth::ColorDepth::Color65kAlt:
+            encode<screen::encoding::Color65kAlt>(m_pixels, encoded);
+            break;
+        default:
+            break;
+    }
+
+    if (m_bytes + encoded.size() > screen::glyph::CacheCapacityBytes) {
+        clear();
+    }
+    m_bytes += encoded.size();
+
+    return m_glyphs.emplace(key, std::move(encoded)).first->second;
+}
+
+void GlyphCache::clear() {
+
+    m_glyphs.clear();
+    m_bytes = 0;
+}
+
+size_t GlyphCache::sizeBytes() const {
+
+    return m_bytes;
+}
@@ -10,41 +10,69 @@
 #include <sys/mman.h>  // mmap, munmap
 #include <vector>      // vector
 #include <string_view> // string_view
+#include <algorithm>   // min, max
 
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "glyph_masks.h"
+#include "utf8.h"
 #include "screen.h"
 
 using namespace std::chrono_literals;
 
 Screen::Screen(const std::string &uio_device) {
 
-    const std::string path = "/dev/" + uio_device;
+    if (Emulator::isEmulated(uio_device)) {
+        m_emulator = std::make_unique<Emulator>(uio_device);
+    } else {
+        const std::string path = "/dev/" + uio_device;
 
-    m_fd = open(path.c_str(), O_RDWR | O_SYNC);
-    if (m_fd < 0) {
-        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
-    }
+        m_fd = open(path.c_str(), O_RDWR | O_SYNC);
+        if (m_fd < 0) {
+            throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+        }
 
-    m_reg = reinterpret_cast<volatile uint32_t *>(mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0));
+        m_reg = reinterpret_cast<volatile uint32_t *>(mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0));
 
-    if (m_reg == MAP_FAILED) {
-        close(m_fd);
-        m_fd = -1;
-        throw std::runtime_error("mmap failed for " + path + ": " + std::strerror(errno));
+        if (m_reg == MAP_FAILED) {
+            close(m_fd);
+            m_fd = -1;
+            throw std::runtime_error("mmap failed for " + path + ": " + std::strerror(errno));
+        }
+
+        // Fails when the device tree gives the IP no interrupt, the waits then only poll
+        m_interrupt = enableInterrupt();
     }
 
+    m_txFifoDepth = detectTxFifo();
+    detectSpiClockDivider();
+
+    // IPs without the sources read the bit as 0, the waits then wake up on a slice at a time.
+    // A previous process may have left them enabled
+    m_interruptSources = readRegister(screen::reg::IP_INFO) & screen::mask::IRQ;
+    disarmInterrupt();
+
     if (!setOnOff(true)) {
-        munmap((void*)m_reg, MAP_SIZE);
-        close(m_fd);
+        if (m_reg) {
+            munmap((void*)m_reg, MAP_SIZE);
+            close(m_fd);
+        }
         m_fd = -1;
         m_reg = nullptr;
         throw std::runtime_error("Screen did not power ON within timeout");
     }
+
+    calibrateWaits();
 }
 
 Screen::~Screen() {
 
+    stopTrace();
+
+    if (m_emulator) {
+        setOnOff(false);
+    }
+
     if (m_reg && m_reg != MAP_FAILED) {
         setOnOff(false);
         munmap((void*)m_reg, MAP_SIZE);
@@ -57,6 +85,8 @@ Screen::~Screen() {
 
 bool Screen::setOnOff(bool value) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::SetOnOff);
+
     writePowerState(value);
     if (value) {
         return waitForPowerState(screen::PowerState::On, std::chrono::seconds(1));
@@ -77,6 +107,8 @@ bool Screen::getOnOff() {
 
 bool Screen::clearWindow(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::ClearWindow);
+
     // Check geometry
     if (c1 >= screen::Geometry::Columns || c2 >= screen::Geometry::Columns || r1 >= screen::Geometry::Rows || r2 >= screen::Geometry::Rows) {
         return false;
@@ -101,6 +133,8 @@ void Screen::clearScreen() {
 
 bool Screen::drawBitmap(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const std::vector<screen::Color> &colors) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawBitmap);
+
     // Check geometry
     if (c1 > c2 || r1 > r2 || c2 >= screen::Geometry::Columns || r2 >= screen::Geometry::Rows) {
         return false;
@@ -122,6 +156,8 @@ bool Screen::drawBitmap(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const st
 
 bool Screen::drawLine(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const screen::Color color) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawLine);
+
     // Check geometry
     if (c1 >= screen::Geometry::Columns || c2 >= screen::Geometry::Columns || r1 >= screen::Geometry::Rows || r2 >= screen::Geometry::Rows) {
         return false;
@@ -140,6 +176,8 @@ bool Screen::drawLine(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const scre
 
 bool Screen::drawRectangle(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const screen::Color colorLine, const screen::Color colorFill) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawRectangle);
+
     // Check geometry
     if (c1 >= screen::Geometry::Columns || c2 >= screen::Geometry::Columns || r1 >= screen::Geometry::Rows || r2 >= screen::Geometry::Rows) {
         return false;
@@ -167,13 +205,15 @@ bool Screen::drawRectangle(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const
 
 bool Screen::drawCircle(uint8_t x, uint8_t y, uint8_t d, const screen::Color colorLine) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawCircle);
+
     // Check geometry
     if (d == 0 || x + d > screen::Geometry::Columns || y + d > screen::Geometry::Rows) {
         return false;
     }
 
-    // Initialize bitmap
-    std::vector<screen::Color> bitmap(d*d, screen::StandardColor::Black);
+    // Outline pixels, only those are sent
+    std::vector<uint8_t> outline(d * d, 0);
 
     //////////////////////////////////////////
     /// BASED ON MIDPOINT CIRCLE ALGORITHM ///
@@ -196,7 +236,7 @@ bool Screen::drawCircle(uint8_t x, uint8_t y, uint8_t d, const screen::Color col
             // Convert from circle coords to bitmap coords
             uint8_t col = (d % 2) ? (lx + r) : ((lx > 0) ? (lx + r - 1) : (lx + r));
             uint8_t row = (d % 2) ? (-ly + r) : ((ly > 0) ? (-ly+ r) : (-ly + r -1));
-            bitmap[row * d + col] = colorLine;
+            outline[row * d + col] = 1;
             // std::cout << "(col, row): (" << static_cast<int>(col) << "," << static_cast<int>(row) << ")" << std::endl;
         }
     };
@@ -226,13 +266,15 @@ bool Screen::drawCircle(uint8_t x, uint8_t y, uint8_t d, const screen::Color col
         py++;
     }
 
-    drawBitmap(x, y, x + d - 1, y + d - 1, bitmap);
+    drawOutlineRuns(x, y, d, outline, colorLine);
 
     return true;
 }
 
 bool Screen::copyWindow(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t c3, uint8_t r3) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::CopyWindow);
+
     // Check geometry
     // Valid starting window
     if (c1 > c2 || r1 > r2 || c2 >= screen::Geometry::Columns || r2 >= screen::Geometry::Rows) {
@@ -251,6 +293,8 @@ bool Screen::copyWindow(uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t
 
 bool Screen::drawImage(const std::string &path) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawImage);
+
     std::vector<screen::Color> bitmap = importImageAsBitmap(path);
 
     if (bitmap.empty() || bitmap.size() != screen::Geometry::Pixels) {
@@ -262,8 +306,60 @@ bool Screen::drawImage(const std::string &path) {
     return true;
 }
 
+bool Screen::drawCanvas(const Canvas &canvas, uint8_t x, uint8_t y) {
+
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawCanvas);
+
+    if (canvas.width() == 0 || canvas.height() == 0 ||
+        x + canvas.width() > screen::Geometry::Columns || y + canvas.height() > screen::Geometry::Rows) {
+        return false;
+    }
+
+    return drawBitmap(x, y, x + canvas.width() - 1, y + canvas.height() - 1, canvas.pixels());
+}
+
+bool Screen::drawCanvas(const Canvas &canvas, std::span<const screen::canvas::Span> spans, uint8_t x, uint8_t y) {
+
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawCanvas);
+
+    if (x + canvas.width() > screen::Geometry::Columns || y + canvas.height() > screen::Geometry::Rows) {
+        return false;
+    }
+
+    const std::vector<screen::Color> &pixels = canvas.pixels();
+    bool ok = true;
+
+    size_t i = 0;
+    while (i < spans.size()) {
+        const screen::canvas::Span &first = spans[i];
+        if (first.x1 > first.x2 || first.x2 >= canvas.width() || first.y >= canvas.height()) {
+            return false;
+        }
+
+        size_t next = i + 1;
+        while (next < spans.size() && spans[next].x1 == first.x1 && spans[next].x2 == first.x2 &&
+               spans[next].y == spans[next - 1].y + 1 && spans[next].y < canvas.height()) {
+            next++;
+        }
+        const uint8_t lastRow = spans[next - 1].y;
+
+        m_canvasWindow.clear();
+        for (size_t row = first.y; row <= lastRow; row++) {
+            const size_t start = row * canvas.width();
+            m_canvasWindow.insert(m_canvasWindow.end(), pixels.begin() + start + first.x1, pixels.begin() + start + first.x2 + 1);
+        }
+
+        ok = drawBitmap(x + first.x1, y + first.y, x + first.x2, y + lastRow, m_canvasWindow) && ok;
+        i = next;
+    }
+
+    return ok;
+}
+
 bool Screen::drawSymbol(const uint8_t symbol, uint8_t x, uint8_t y, const screen::Font &font, screen::Color color) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawSymbol);
+
     std::vector<screen::Color> bitmap = importSymbolAsBitmap(symbol, font, color);
 
     return drawBitmap(x, y, x + font.width - 1, y + font.height - 1, bitmap);
@@ -271,41 +367,99 @@ bool Screen::drawSymbol(const uint8_t symbol, uint8_t x, uint8_t y, const screen
 
 bool Screen::drawString(std::string_view phrase, uint8_t x, uint8_t y, const screen::Font &font, screen::Color color) {
 
-    size_t i = 0;
-    bool valid = true;
-
-    uint8_t pixelCol = 0;
-    uint8_t pixelRow = 0;
-    uint8_t incrCol = 0;
-    uint8_t incrRow = 0;
-
-    if (m_orientation == screen::Orientation::Horizontal_0 || m_orientation == screen::Orientation::Horizontal_180) {
-        pixelCol = x;
-        pixelRow = y;
-        incrCol = font.width;
-        incrRow = 0;
-    } else {
-        pixelCol = y;
-        pixelRow = x;
-        incrCol = 0;
-        incrRow = font.width;
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawString);
+
+    m_textRun.clear();
+    screen::utf8::decode(phrase, m_textRun);
+
+    // Only whole glyphs are drawn, up to the screen edge
+    const size_t room = (x < textLineLimit()) ? (textLineLimit() - x) / font.width : 0;
+    const size_t count = std::min(m_textRun.size(), room);
+    const size_t width = count * font.width;
+
+    m_textLine.assign(width * font.height, screen::StandardColor::Black);
+
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t codepoint = m_textRun[i];
+        const uint8_t symbol = (codepoint < 256) ? static_cast<uint8_t>(codepoint) : '?';
+        const uint8_t *glyph = &font.bitmap[symbol * font.height];
+
+        for (size_t row = 0; row < font.height; row++) {
+            const screen::glyph::RowMask &mask = screen::glyph::RowMasks[glyph[row]];
+            screen::Color *out = &m_textLine[row * width + i * font.width];
+            for (size_t col = 0; col < font.width; col++) {
+                out[col] = screen::glyph::blend(color, mask[col]);
+            }
+        }
+    }
+
+    const bool valid = drawTextLine(x, y, width, font.height);
+
+    return valid && count == m_textRun.size();
+}
+
+bool Screen::drawString(std::string_view phrase, uint8_t x, uint8_t y, const BitmapFont &font, screen::Color color, screen::Color background) {
+
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawString);
+
+    if (font.empty()) {
+        return false;
     }
 
-    while (i < phrase.size()) {
-        size_t len = 0;
-        uint32_t codepoint = utf8_decode((const uint8_t*)&phrase[i], &len);
-        uint8_t glyph = (codepoint < 256) ? static_cast<uint8_t>(codepoint) : '?';
-        valid &= drawSymbol(glyph, pixelCol , pixelRow, font, color);
-        pixelCol += incrCol;
-        pixelRow += incrRow;
-        i += len;
+    font.shape(phrase, m_textRun);
+
+    // Only whole glyphs are drawn, up to the screen edge
+    const size_t room = (x < textLineLimit()) ? textLineLimit() - x : 0;
+    size_t count = 0;
+    size_t width = 0;
+    size_t pen = 0;
+
+    for (uint32_t index : m_textRun) {
+        const BitmapFont::Glyph &glyph = font.glyph(index);
+        if (pen + glyph.width > room) {
+            break;
+        }
+        width = std::max(width, pen + glyph.width);
+        pen += glyph.advance;
+        count++;
     }
 
-    return valid;
+    if (composeRun(std::span<const uint32_t>(m_textRun).first(count), width, 0, font, color, background) == 0) {
+        return false;
+    }
+
+    const bool valid = sendTextLine(x, y, width, font.height());
+
+    return valid && count == m_textRun.size();
+}
+
+bool Screen::drawGlyphRun(std::span<const uint32_t> run, uint8_t x, uint8_t y, uint8_t width, uint8_t offset, const BitmapFont &font, screen::Color color, screen::Color background) {
+
+    return drawGlyphRun(run, x, y, width, offset, font, color, background, 0, width);
+}
+
+bool Screen::drawGlyphRun(std::span<const uint32_t> run, uint8_t x, uint8_t y, uint8_t width, uint8_t offset, const BitmapFont &font, screen::Color color, screen::Color background, uint8_t begin, uint8_t end) {
+
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::DrawGlyphRun);
+
+    if (font.empty() || x + width > textLineLimit() || begin > end || end > width) {
+        return false;
+    }
+
+    // The whole line is composed so glyphs crossing the edges are cut, not skipped
+    const size_t bytesPerPixel = composeRun(run, width, offset, font, color, background);
+    if (bytesPerPixel == 0) {
+        return false;
+    }
+    cropTextLine(width, font.height(), begin, end, bytesPerPixel);
+
+    return sendTextLine(x + begin, y, end - begin, font.height());
 }
 
 bool Screen::setupScrolling(uint8_t horizontalScrollOffset, uint8_t startRow, uint8_t rowsNumber, uint8_t verticalScrollOffset, uint8_t timeInterval) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::SetupScrolling);
+
     // Valid scroll offset
     if (horizontalScrollOffset >= screen::Geometry::Columns || verticalScrollOffset >= screen::Geometry::Rows ) {
         return false;
@@ -327,6 +481,8 @@ bool Screen::setupScrolling(uint8_t horizontalScrollOffset, uint8_t startRow, ui
 
 void Screen::enableScrolling(bool value) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::EnableScrolling);
+
     sendCommand(value ? screen::Command::ActivateScroll : screen::Command::DeactivateScroll);
 }
 
@@ -340,8 +496,117 @@ std::chrono::nanoseconds Screen::getSpiDelay() const {
     return m_spiDelay;
 }
 
+void Screen::setWaitPolicy(screen::wait::Policy policy) {
+
+    m_waitPolicy = policy;
+}
+
+screen::wait::Policy Screen::getWaitPolicy() const {
+
+    return m_waitPolicy;
+}
+
+bool Screen::hasInterrupt() const {
+
+    return m_interrupt;
+}
+
+bool Screen::hasInterruptSources() const {
+
+    return m_interruptSources;
+}
+
+screen::wait::Calibration Screen::getWaitCalibration() const {
+
+    return m_calibration;
+}
+
+uint32_t Screen::getTxFifoDepth() const {
+
+    return m_txFifoDepth;
+}
+
+void Screen::setTxFifoEnable(bool enable) {
+
+    m_txFifoEnable = enable;
+}
+
+bool Screen::getTxFifoEnable() const {
+
+    return m_txFifoEnable;
+}
+
+bool Screen::setSpiClockDivider(uint32_t divider) {
+
+    if (m_spiClockDivider == 0 || divider < screen::spi::MinClockDivider || divider > screen::spi::MaxClockDivider) {
+        return false;
+    }
+
+    if (divider == m_spiClockDivider) {
+        return true;
+    }
+
+    // The divider changes between bytes, so the queued ones are sent first
+    const bool on = readPowerState() == screen::PowerState::On;
+    if (on) {
+        waitForSpiReady();
+    }
+
+    writeRegister(screen::reg::SPI_CLK_DIV, divider << screen::bit::CLK_DIV);
+    m_spiClockDivider = divider;
+
+    // Bytes sent at a divider the controller could not follow, e.g. during calibration, may have been garbled
+    m_commandCache.invalidate();
+
+    // The adaptive waits follow the byte time, which only an ON controller can measure
+    if (on) {
+        calibrateWaits();
+    }
+    return true;
+}
+
+void Screen::attachDma(const std::string &dma_device) {
+
+    if (m_dmaBusy) {
+        finishDma();
+    }
+    m_dma = std::make_unique<FrameDma>(dma_device, m_emulator.get());
+}
+
+bool Screen::hasDma() const {
+
+    return m_dma && m_stream;
+}
+
+void Screen::setDmaEnable(bool enable) {
+
+    m_dmaEnable = enable;
+}
+
+bool Screen::getDmaEnable() const {
+
+    return m_dmaEnable;
+}
+
+void Screen::setCommandCacheEnable(bool enable) {
+
+    m_commandCacheEnable = enable;
+}
+
+bool Screen::getCommandCacheEnable() const {
+
+    return m_commandCacheEnable;
+}
+
+uint32_t Screen::getSpiClockDivider() const {
+
+    return m_spiClockDivider;
+}
+
 void Screen::setScreenOrientation(const screen::Orientation orientation) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::SetScreenOrientation);
+
     m_orientation = orientation;
 
     switch (m_orientation) {
@@ -379,6 +644,8 @@ screen::Orientation Screen::getScreenOrientation() const {
 
 void Screen::setFillRectangleEnable(bool fillRectangle) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::SetFillRectangleEnable);
+
     m_fillRectangle = fillRectangle;
     uint8_t param = static_cast<uint8_t>(m_fillRectangle) | (static_cast<uint8_t>(m_reverseCopy) << 4);
     sendCommand(screen::Command::FillEnable, param);
@@ -386,6 +653,8 @@ void Screen::setFillRectangleEnable(bool fillRectangle) {
 
 void Screen::setReverseCopyEnable(bool reverseCopy) {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::SetReverseCopyEnable);
+
     m_reverseCopy = reverseCopy;
     uint8_t param = static_cast<uint8_t>(m_fillRectangle) | (static_cast<uint8_t>(m_reverseCopy) << 4);
     sendCommand(screen::Command::FillEnable, param);
@@ -393,11 +662,38 @@ void Screen::setReverseCopyEnable(bool reverseCopy) {
 
 void Screen::applyDefaultSettings() {
 
+    screen::metrics::Scope scope(m_metrics, screen::metrics::Method::ApplyDefaultSettings);
+
     setSpiDelay(screen::defaultSpiDelay);
+    setWaitPolicy(screen::wait::defaultPolicy);
+    setTxFifoEnable(true);
+    setDmaEnable(true);
+    setCommandCacheEnable(true);
+    setSpiClockDivider(m_spiClockDividerDefault);
     setFillRectangleEnable(screen::defaultFillRectangle);
     setReverseCopyEnable(screen::defaultReverseCopy);
     m_orientation = screen::defaultOrientation;
 
     applyColumnRowAddr(screen::ApplyMode::Default);
     applyRemapColorDepth(screen::ApplyMode::Default);
-}
\ No newline at end of file
+}
+
+screen::metrics::Snapshot Screen::getMetrics() const {
+
+    return screen::metrics::snapshot(m_metrics);
+}
+
+uint64_t Screen::getBytesSent() const {
+
+    return screen::metrics::totalBytes(m_metrics);
+}
+
+void Screen::resetMetrics() {
+
+    screen::metrics::reset(m_metrics);
+}
+
+const Emulator *Screen::getEmulator() const {
+
+    return m_emulator.get();
+}
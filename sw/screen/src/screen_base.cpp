@@ -1,24 +1,57 @@
 #include <iostream>   // cout, endl
 #include <chrono>     // time
-#include <thread>     // sleep_for
+#include <thread>     // sleep_for, yield
+#include <atomic>     // atomic_signal_fence
+#include <algorithm>  // max, min
 #include <span>       // span
+#include <poll.h>     // poll
+#include <unistd.h>   // read, write
 
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "pixel_encoding.h"
 #include "screen.h"
 
+namespace {
+
+    // SPI_CTRL value that sends byte
+    uint32_t spiControl(uint8_t byte, screen::DataMode mode) {
+
+        return (static_cast<uint32_t>(byte) << screen::bit::BYTE)
+             | (static_cast<uint32_t>(mode) << screen::bit::DC_SELECT)
+             | (screen::mask::SPI_TRIGGER);
+    }
+}
+
 void Screen::writeRegister(size_t reg, uint32_t value) {
 
+    // Pushes of the registers would go in between the bytes of the frame
+    if (m_dmaBusy) {
+        finishDma();
+    }
+
+    if (m_emulator) {
+        m_emulator->writeRegister(reg, value);
+        return;
+    }
     m_reg[reg] = value;
 }
 
 uint32_t Screen::readRegister(size_t reg) const {
 
+    if (m_emulator) {
+        return m_emulator->readRegister(reg);
+    }
     return m_reg[reg];
 }
 
 void Screen::writePowerState(bool value) {
 
+    // Bytes still in the TX queue are sent before the controller turns off
+    if (m_txFifoDepth > 0 && !value && readPowerState() == screen::PowerState::On) {
+        waitForSpiReady();
+    }
+
     uint32_t ctrl = readRegister(screen::reg::POWER_CTRL);
 
     if (value) {
@@ -28,6 +61,9 @@ void Screen::writePowerState(bool value) {
     }
 
     writeRegister(screen::reg::POWER_CTRL, ctrl);
+
+    // The controller resets its registers when it turns on
+    m_commandCache.invalidate();
 }
 
 screen::PowerState Screen::readPowerState() const {
@@ -48,44 +84,382 @@ bool Screen::isSpiDataRequest() const {
     return status & screen::mask::SPI_DATA_REQUEST;
 }
 
-void Screen::sendSpiByte(uint8_t byte, screen::DataMode mode) {
+void Screen::waitForSpiReady() {
+
+    // The TX queue can run empty while the DMA is still reading the buffer
+    if (m_dmaBusy) {
+        finishDma();
+    }
+
+    if (isSpiReady()) {
+        return;
+    }
+
+    const uint64_t start = screen::metrics::nowNs();
+    bool armed = false;
 
     while (!isSpiReady()) {
-        // Wait
+        switch (m_waitPolicy) {
+            case screen::wait::Policy::Spin:
+                break;
+            case screen::wait::Policy::Yield:
+                std::this_thread::yield();
+                break;
+            case screen::wait::Policy::Hybrid:
+            case screen::wait::Policy::Adaptive:
+                // A transfer that outlasts the spin budget is stalled, sleep until the IP interrupts
+                if (screen::metrics::nowNs() - start > static_cast<uint64_t>(screen::wait::SpinBudget.count())) {
+                    if (m_interrupt && m_interruptSources && !armed) {
+                        // The status is read again before sleeping, the queue may have run idle meanwhile
+                        armInterrupt(screen::mask::IRQ_TX_IDLE);
+                        armed = true;
+                    } else if (m_interrupt) {
+                        waitForInterrupt(screen::wait::BlockSlice);
+                    } else if (m_waitPolicy == screen::wait::Policy::Adaptive) {
+                        std::this_thread::yield();
+                    }
+                }
+                break;
+        }
     }
 
-    uint32_t value = (static_cast<uint32_t>(byte) << screen::bit::BYTE)
-                    | (static_cast<uint32_t>(mode) << screen::bit::DC_SELECT)
-                    | (screen::mask::SPI_TRIGGER);
+    if (armed) {
+        disarmInterrupt();
+    }
+}
 
-    writeRegister(screen::reg::SPI_CTRL, value);
+void Screen::waitDelay(std::chrono::nanoseconds delay) {
 
-    if (m_spiDelay.count() > 0) {
-        std::this_thread::sleep_for(m_spiDelay);
+    // The delay is a minimum, so it is timed with the clock rather than the delay loop
+    if (m_waitPolicy == screen::wait::Policy::Adaptive && delay < screen::wait::SleepThreshold) {
+        const uint64_t end = screen::metrics::nowNs() + static_cast<uint64_t>(delay.count());
+        while (screen::metrics::nowNs() < end) {
+            // Wait
+        }
+        return;
     }
+    std::this_thread::sleep_for(delay);
+}
+
+void Screen::delayLoops(uint64_t loops) const {
 
+    for (uint64_t i = 0; i < loops; i++) {
+        // Keeps the compiler from removing the loop
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+}
+
+void Screen::calibrateWaits() {
+
+    // Delay loop speed, timed the second time so the first one warms the CPU up
+    delayLoops(screen::wait::CalibrationLoops);
+    uint64_t start = screen::metrics::nowNs();
+    delayLoops(screen::wait::CalibrationLoops);
+    const uint64_t loopNs = std::max<uint64_t>(screen::metrics::nowNs() - start, 1);
+    m_calibration.loopsPerNs = static_cast<double>(screen::wait::CalibrationLoops) / loopNs;
+
+    // Byte time, with Nop commands polled as fast as possible
     while (!isSpiReady()) {
         // Wait
     }
+
+    // The Nops are on the wire like any other command, so they are traced and counted as well
+    const uint8_t nop = static_cast<uint8_t>(screen::Command::Nop);
+    uint64_t busyPolls = 0;
+    start = screen::metrics::nowNs();
+    for (uint32_t i = 0; i < screen::wait::CalibrationBytes; i++) {
+        if (m_trace) {
+            recordTrace(nop, screen::DataMode::Command);
+        }
+        const uint64_t byteStart = screen::metrics::nowNs();
+        writeRegister(screen::reg::SPI_CTRL, spiControl(nop, screen::DataMode::Command));
+        while (!isSpiReady()) {
+            busyPolls++;
+        }
+        screen::metrics::add(m_metrics.commandBytes, 1);
+        screen::metrics::record(m_metrics.commands[nop], screen::metrics::nowNs() - byteStart, 1);
+    }
+    m_calibration.byteTime = std::chrono::nanoseconds((screen::metrics::nowNs() - start) / screen::wait::CalibrationBytes);
+
+    // An IP that is never busy after a write (or the emulator) leaves nothing to wait out
+    m_byteDelayLoops = 0;
+    if (busyPolls > 0) {
+        m_byteDelayLoops = static_cast<uint64_t>(m_calibration.byteTime.count() * m_calibration.loopsPerNs * screen::wait::DelayPercent / 100);
+    }
+}
+
+bool Screen::enableInterrupt() {
+
+    if (m_fd < 0) {
+        return false;
+    }
+
+    const uint32_t enable = 1;
+    return write(m_fd, &enable, sizeof(enable)) == sizeof(enable);
+}
+
+bool Screen::waitForInterrupt(std::chrono::milliseconds timeout) {
+
+    pollfd pfd = {m_fd, POLLIN, 0};
+
+    if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+        screen::metrics::add(m_metrics.interruptTimeouts, 1);
+        return false;
+    }
+
+    // Interrupt count, only its arrival matters
+    uint32_t count = 0;
+    if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+        screen::metrics::add(m_metrics.interruptTimeouts, 1);
+        return false;
+    }
+
+    screen::metrics::add(m_metrics.interruptWakeups, 1);
+
+    // The line of the IP stays high until its sources are acknowledged
+    if (m_interruptSources) {
+        writeRegister(screen::reg::IRQ_STATUS, screen::mask::IRQ_SOURCES);
+    }
+    enableInterrupt();
+    return true;
+}
+
+void Screen::armInterrupt(uint32_t sources) {
+
+    writeRegister(screen::reg::IRQ_STATUS, sources);
+    writeRegister(screen::reg::IRQ_ENABLE, sources);
+}
+
+void Screen::disarmInterrupt() {
+
+    if (!m_interruptSources) {
+        return;
+    }
+    writeRegister(screen::reg::IRQ_ENABLE, 0);
+    writeRegister(screen::reg::IRQ_STATUS, screen::mask::IRQ_SOURCES);
+}
+
+void Screen::sendSpiByte(uint8_t byte, screen::DataMode mode) {
+
+    if (m_trace) {
+        recordTrace(byte, mode);
+    }
+
+    waitForSpiReady();
+
+    writeRegister(screen::reg::SPI_CTRL, spiControl(byte, mode));
+
+    // Most of the byte away from the bus instead of reading the status over and over
+    if (m_bulkTransfer && m_waitPolicy == screen::wait::Policy::Adaptive) {
+        delayLoops(m_byteDelayLoops);
+    }
+
+    if (m_spiDelay.count() > 0) {
+        waitDelay(m_spiDelay);
+    }
+
+    waitForSpiReady();
 }
 
 void Screen::sendCommand(screen::Command cmd, std::span<const uint8_t> params) {
 
-    sendSpiByte(static_cast<uint8_t>(cmd), screen::DataMode::Command);
+    if (m_commandCacheEnable && m_commandCache.isRedundant(cmd, params)) {
+        screen::metrics::add(m_metrics.suppressedCommands, 1);
+        screen::metrics::add(m_metrics.suppressedCommandBytes, 1 + params.size());
+        return;
+    }
+    m_commandCache.commit(cmd, params);
+
+    const uint64_t start = screen::metrics::nowNs();
+
+    if (useTxFifo()) {
+        m_commandBytes.assign(1, static_cast<uint8_t>(cmd));
+        m_commandBytes.insert(m_commandBytes.end(), params.begin(), params.end());
+        postBytes(m_commandBytes.data(), m_commandBytes.size(), screen::DataMode::Command);
+    } else {
+        sendSpiByte(static_cast<uint8_t>(cmd), screen::DataMode::Command);
 
-    for (uint8_t p : params) {
-        sendSpiByte(p, screen::DataMode::Command);
+        for (uint8_t p : params) {
+            sendSpiByte(p, screen::DataMode::Command);
+        }
     }
+
+    const uint64_t bytes = 1 + params.size();
+    screen::metrics::add(m_metrics.commandBytes, bytes);
+    screen::metrics::record(m_metrics.commands[static_cast<uint8_t>(cmd)], screen::metrics::nowNs() - start, bytes);
 }
 
 void Screen::sendData(const uint8_t data) {
 
-    sendSpiByte(data, screen::DataMode::Data);
+    if (useTxFifo()) {
+        postBytes(&data, 1, screen::DataMode::Data);
+    } else {
+        sendSpiByte(data, screen::DataMode::Data);
+    }
+    screen::metrics::add(m_metrics.dataBytes, 1);
+    m_commandCache.addData(1);
 }
 
 void Screen::sendMultiData(const uint8_t *data, size_t length) {
 
+    if (useTxFifo()) {
+        postBytes(data, length, screen::DataMode::Data);
+        screen::metrics::add(m_metrics.dataBytes, length);
+        m_commandCache.addData(length);
+        return;
+    }
+
+    m_bulkTransfer = m_calibration.byteTime * length >= screen::wait::BulkThreshold;
+
     for (size_t i = 0; i < length; i++) {
         sendSpiByte(data[i], screen::DataMode::Data);
     }
-}
\ No newline at end of file
+
+    m_bulkTransfer = false;
+    screen::metrics::add(m_metrics.dataBytes, length);
+    m_commandCache.addData(length);
+}
+
+uint32_t Screen::detectTxFifo() {
+
+    // IPs without the TX queue read FIFO_EMPTY as 0, and nothing has been sent yet
+    if (!(readRegister(screen::reg::SPI_STATUS) & screen::mask::FIFO_EMPTY)) {
+        return 0;
+    }
+
+    const uint32_t info = readRegister(screen::reg::IP_INFO);
+    m_stream = info & screen::mask::STREAM;
+
+    m_burstControl = readRegister(screen::reg::SPI_BURST_CTRL);
+    return (info & screen::mask::FIFO_DEPTH) >> screen::bit::FIFO_DEPTH;
+}
+
+void Screen::detectSpiClockDivider() {
+
+    // IPs without the register read the default as 0
+    const uint32_t value = readRegister(screen::reg::SPI_CLK_DIV);
+    m_spiClockDividerDefault = (value & screen::mask::CLK_DIV_DEFAULT) >> screen::bit::CLK_DIV_DEFAULT;
+
+    const uint32_t divider = (value & screen::mask::CLK_DIV) >> screen::bit::CLK_DIV;
+    m_spiClockDivider = divider ? divider : m_spiClockDividerDefault;
+}
+
+bool Screen::useTxFifo() const {
+
+    // The SPI delay goes between bytes, which only SPI_CTRL writes can do
+    return m_txFifoDepth > 0 && m_txFifoEnable && m_spiDelay.count() == 0;
+}
+
+uint32_t Screen::waitForTxFifoSpace() {
+
+    // The free slots are only ours once the stream is done
+    if (m_dmaBusy) {
+        finishDma();
+    }
+
+    // The level may miss the last writes, which must still find a slot
+    const uint32_t limit = m_txFifoDepth - std::min(screen::burst::FifoReserve, m_txFifoDepth / 2);
+
+    uint32_t level = readTxFifoLevel();
+    if (level < limit) {
+        return limit - level;
+    }
+
+    screen::metrics::add(m_metrics.txFifoFull, 1);
+
+    // A slot frees up every few bytes on the wire, far less than a sleep
+    while (level >= limit) {
+        if (m_waitPolicy != screen::wait::Policy::Spin) {
+            std::this_thread::yield();
+        }
+        level = readTxFifoLevel();
+    }
+    return limit - level;
+}
+
+uint32_t Screen::readTxFifoLevel() {
+
+    const uint32_t status = readRegister(screen::reg::SPI_STATUS);
+
+    // Dropped bytes leave the controller somewhere else than the driver thinks
+    if (status & screen::mask::FIFO_OVERFLOW) {
+        screen::metrics::add(m_metrics.txFifoOverflows, 1);
+        m_commandCache.invalidate();
+        writeRegister(screen::reg::SPI_STATUS, screen::mask::FIFO_OVERFLOW);
+    }
+    return (status & screen::mask::FIFO_LEVEL) >> screen::bit::FIFO_LEVEL;
+}
+
+void Screen::postBytes(const uint8_t *data, size_t length, screen::DataMode mode) {
+
+    const uint32_t dc = (mode == screen::DataMode::Data) ? screen::mask::BURST_DC : 0;
+    uint32_t space = 0;
+
+    for (size_t i = 0; i < length; i += screen::burst::MaxBytes) {
+        const size_t count = std::min<size_t>(screen::burst::MaxBytes, length - i);
+
+        const uint32_t control = dc | static_cast<uint32_t>(count - 1) << screen::bit::BURST_COUNT;
+        if (control != m_burstControl) {
+            writeRegister(screen::reg::SPI_BURST_CTRL, control);
+            m_burstControl = control;
+        }
+
+        // First byte in the lowest lane
+        uint32_t word = 0;
+        for (size_t b = 0; b < count; b++) {
+            word |= static_cast<uint32_t>(data[i + b]) << (8 * b);
+            if (m_trace) {
+                recordTrace(data[i + b], mode);
+            }
+        }
+
+        if (space == 0) {
+            space = waitForTxFifoSpace();
+        }
+        writeRegister(screen::reg::SPI_BURST, word);
+        space--;
+    }
+
+    screen::metrics::add(m_metrics.txFifoWrites, (length + screen::burst::MaxBytes - 1) / screen::burst::MaxBytes);
+}
+
+bool Screen::useDma(size_t length) const {
+
+    // The stream goes through the TX queue, which leaves no room for an SPI delay
+    return m_dma && m_dmaEnable && m_stream && useTxFifo() && length >= screen::dma::MinTransferBytes && length <= m_dma->capacity();
+}
+
+bool Screen::startDma(size_t length) {
+
+    // Read back so the commands posted before the frame reach the IP before the DMA starts reading
+    readRegister(screen::reg::SPI_STATUS);
+
+    if (!m_dma->start(length)) {
+        screen::metrics::add(m_metrics.dmaErrors, 1);
+        return false;
+    }
+    m_dmaBusy = true;
+
+    if (m_trace) {
+        const uint8_t *data = m_dma->buffer();
+        for (size_t i = 0; i < length; i++) {
+            recordTrace(data[i], screen::DataMode::Data);
+        }
+    }
+
+    screen::metrics::add(m_metrics.dmaTransfers, 1);
+    screen::metrics::add(m_metrics.dataBytes, length);
+    m_commandCache.addData(length);
+    return true;
+}
+
+void Screen::finishDma() {
+
+    m_dmaBusy = false;
+
+    // The rest of the frame is lost, the next one drawn over it, and the RAM pointer with it
+    if (!m_dma->wait()) {
+        screen::metrics::add(m_metrics.dmaErrors, 1);
+        m_commandCache.invalidate();
+    }
+}
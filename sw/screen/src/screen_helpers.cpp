@@ -1,7 +1,8 @@
-#include <iostream> // cout
-#include <cstring>  // string
-#include <chrono>   // time
-#include <thread>   // sleep_for
+#include <iostream>  // cout
+#include <cstring>   // string, memmove
+#include <chrono>    // time
+#include <thread>    // sleep_for
+#include <algorithm> // min
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image/stb_image.h"
@@ -10,24 +11,47 @@
 #include "stb_image/stb_image_resize2.h"
 
 #include "screen_constants.h"
+#include "glyph_masks.h"
+#include "pixel_encoding.h"
 #include "screen_registers.h"
 #include "screen.h"
 
 bool Screen::waitForPowerState(screen::PowerState target, std::chrono::milliseconds timeout) {
 
     const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const bool sleep = m_interrupt && (m_waitPolicy == screen::wait::Policy::Hybrid || m_waitPolicy == screen::wait::Policy::Adaptive);
 
+    // Armed before the first read, so the end of the transition cannot slip in between
+    if (sleep && m_interruptSources) {
+        armInterrupt(screen::mask::IRQ_POWER);
+    }
+
+    bool reached = false;
     while (true) {
         if (readPowerState() == target) {
-            return true;
+            reached = true;
+            break;
+        }
+
+        const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed >= timeout) {
+            break;
         }
 
-        if (std::chrono::steady_clock::now() - start >= timeout) {
-            return false;
+        // Transitions take milliseconds: sleep on the interrupt when there is one, otherwise a slice at a time.
+        // The IP interrupts at the end of the transition when it has the sources, the whole timeout can be slept
+        if (sleep) {
+            const std::chrono::milliseconds left = std::chrono::ceil<std::chrono::milliseconds>(timeout - elapsed);
+            waitForInterrupt(m_interruptSources ? left : std::min(left, screen::wait::BlockSlice));
+        } else {
+            std::this_thread::sleep_for(screen::wait::BlockSlice);
         }
+    }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (sleep && m_interruptSources) {
+        disarmInterrupt();
     }
+    return reached;
 }
 
 std::vector<screen::Color> Screen::importImageAsBitmap(const std::string &path){
@@ -106,52 +130,210 @@ std::vector<screen::Color> Screen::importSymbolAsBitmap(const uint8_t symbol, co
     // Import the glyph
     const uint8_t *glyph = &font.bitmap[symbol * font.height];
 
-    // Fill bitmap
+    // Fill bitmap, one mask lookup per row and a blend per pixel
     for (size_t row = 0; row < font.height; row++) {
-        uint8_t rowData = glyph[row];
+        const screen::glyph::RowMask &mask = screen::glyph::RowMasks[glyph[row]];
+        screen::Color *out = &bitmap[row * font.width];
         for (size_t col = 0; col < font.width; col++) {
-            bool pixelOn = rowData & (1 << col);
-            bitmap[row * font.width + col] = pixelOn ? color : screen::StandardColor::Black;
+            out[col] = screen::glyph::blend(color, mask[col]);
         }
     }
 
     return bitmap;
 }
 
-uint32_t Screen::utf8_decode(const uint8_t *s, size_t *len) {
-
-    uint32_t codepoint;
-
-    // First byte is 0XXX_XXXX
-    if (s[0] < 0x80) {
-        *len = 1;
-        return s[0];
-    }
-    // First byte is 110X_XXXX
-    if ((s[0] & 0xE0) == 0xC0) {
-        *len = 2;
-         codepoint = ((s[0] & 0x1F) << 6) |
-             (s[1] & 0x3F);
-        return codepoint;
-    }
-    // First byte is 1110_XXXX
-    if ((s[0] & 0xF0) == 0xE0) {
-        *len = 3;
-         codepoint = ((s[0] & 0x0F) << 12) |
-             ((s[1] & 0x3F) << 6) |
-             (s[2] & 0x3F);
-        return codepoint;
-    }
-    // First byte is 1111_0XXX
-    if ((s[0] & 0xF8) == 0xF0) {
-        *len = 4;
-         codepoint = ((s[0] & 0x07) << 18) |
-             ((s[1] & 0x3F) << 12) |
-             ((s[2] & 0x3F) << 6) |
-             (s[3] & 0x3F);
-        return codepoint;
-    }
-
-    *len = 1;
-    return 0xFFFD; // Replacement char
-}
\ No newline at end of file
+uint8_t Screen::textLineLimit() const {
+
+    // Text runs along the rows in vertical orientations
+    const bool vertical = (m_orientation == screen::Orientation::Vertical_90 || m_orientation == screen::Orientation::Vertical_270);
+    return vertical ? screen::Geometry::Rows : screen::Geometry::Columns;
+}
+
+void Screen::rasteriseRun(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background) {
+
+    m_textLine.assign(width * font.height(), background);
+
+    const bool antiAliased = (font.bitsPerPixel() > 1);
+    const screen::glyph::Ramp ramp = screen::glyph::makeRamp(color, background);
+
+    // Glyphs that do not fit entirely in the line are skipped
+    size_t pen = offset;
+    for (uint32_t index : run) {
+        const BitmapFont::Glyph &glyph = font.glyph(index);
+        if (pen + glyph.width <= width) {
+            if (antiAliased) {
+                font.rasterise(glyph, ramp, &m_textLine[pen], width);
+            } else {
+                font.rasterise(glyph, color, &m_textLine[pen], width);
+            }
+        }
+        pen += glyph.advance;
+    }
+}
+
+template <typename Encoding>
+void Screen::composeRunAs(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background) {
+
+    const size_t height = font.height();
+    const size_t rowBytes = width * Encoding::Bytes;
+
+    // Glyphs overlapping the previous one are blended pixel by pixel, then encoded
+    size_t pen = offset;
+    size_t drawnEnd = 0;
+    for (uint32_t index : run) {
+        const BitmapFont::Glyph &glyph = font.glyph(index);
+        if (pen + glyph.width <= width) {
+            if (pen < drawnEnd) {
+                rasteriseRun(run, width, offset, font, color, background);
+                m_pixelBuffer.resize(m_textLine.size() * Encoding::Bytes);
+                screen::encoding::packPixels<Encoding>(m_textLine.data(), m_textLine.size(), m_pixelBuffer.data());
+                return;
+            }
+            drawnEnd = pen + glyph.width;
+        }
+        pen += glyph.advance;
+    }
+
+    // Otherwise the line is the encoded background with the cached glyph rows copied over it
+    uint8_t encodedBackground[Encoding::Bytes];
+    Encoding::pack(background, encodedBackground);
+    m_pixelBuffer.resize(rowBytes * height);
+    for (size_t i = 0; i < width * height; i++) {
+        std::memcpy(&m_pixelBuffer[i * Encoding::Bytes], encodedBackground, Encoding::Bytes);
+    }
+
+    pen = offset;
+    for (uint32_t index : run) {
+        const BitmapFont::Glyph &glyph = font.glyph(index);
+        if (pen + glyph.width <= width && glyph.width > 0) {
+            bool hit = false;
+            const std::span<const uint8_t> encoded = m_glyphCache.get(font, index, color, background, Encoding::Depth, hit);
+            screen::metrics::add(hit ? m_metrics.glyphCacheHits : m_metrics.glyphCacheMisses, 1);
+
+            const size_t glyphRowBytes = glyph.width * Encoding::Bytes;
+            for (size_t row = 0; row < height; row++) {
+                std::memcpy(&m_pixelBuffer[row * rowBytes + pen * Encoding::Bytes], &encoded[row * glyphRowBytes], glyphRowBytes);
+            }
+        }
+        pen += glyph.advance;
+    }
+}
+
+size_t Screen::composeRun(std::span<const uint32_t> run, size_t width, size_t offset, const BitmapFont &font, screen::Color color, screen::Color background) {
+
+    // The color depth is resolved once per line
+    switch (getColorDepth()) {
+        case screen::RemapColorDepth::ColorDepth::Color256:
+            composeRunAs<screen::encoding::Color256>(run, width, offset, font, color, background);
+            return screen::encoding::Color256::Bytes;
+        case screen::RemapColorDepth::ColorDepth::Color65k:
+            composeRunAs<screen::encoding::Color65k>(run, width, offset, font, color, background);
+            return screen::encoding::Color65k::Bytes;
+        case screen::RemapColorDepth::ColorDepth::Color65kAlt:
+            composeRunAs<screen::encoding::Color65kAlt>(run, width, offset, font, color, background);
+            return screen::encoding::Color65kAlt::Bytes;
+        default:
+            return 0;
+    }
+}
+
+void Screen::cropTextLine(size_t width, uint8_t height, size_t begin, size_t end, size_t bytesPerPixel) {
+
+    const size_t cropped = (end - begin) * bytesPerPixel;
+    const size_t rowBytes = width * bytesPerPixel;
+    if (cropped == rowBytes) {
+        return;
+    }
+
+    // Rows only move towards the front, so the line is cropped in place
+    for (size_t row = 0; row < height; row++) {
+        std::memmove(&m_pixelBuffer[row * cropped], &m_pixelBuffer[row * rowBytes + begin * bytesPerPixel], cropped);
+    }
+    m_pixelBuffer.resize(cropped * height);
+}
+
+bool Screen::drawTextLine(uint8_t x, uint8_t y, size_t width, uint8_t height) {
+
+    if (width == 0) {
+        return true;
+    }
+
+    // Vertical orientations fill the window column by column, so the same
+    // row-major line is drawn into the transposed window
+    if (textLineLimit() == screen::Geometry::Rows) {
+        return drawBitmap(y, x, y + height - 1, x + width - 1, m_textLine);
+    }
+    return drawBitmap(x, y, x + width - 1, y + height - 1, m_textLine);
+}
+
+bool Screen::sendTextLine(uint8_t x, uint8_t y, size_t width, uint8_t height) {
+
+    if (width == 0) {
+        return true;
+    }
+
+    // Same windows as drawTextLine, with the line already encoded
+    const bool vertical = (textLineLimit() == screen::Geometry::Rows);
+    const size_t c1 = vertical ? y : x;
+    const size_t r1 = vertical ? x : y;
+    const size_t c2 = vertical ? y + height - 1 : x + width - 1;
+    const size_t r2 = vertical ? x + width - 1 : y + height - 1;
+
+    if (c2 >= screen::Geometry::Columns || r2 >= screen::Geometry::Rows) {
+        return false;
+    }
+
+    setColumnRowAddr(static_cast<uint8_t>(c1), static_cast<uint8_t>(r1), static_cast<uint8_t>(c2), static_cast<uint8_t>(r2));
+    applyColumnRowAddr();
+    sendMultiData(m_pixelBuffer.data(), m_pixelBuffer.size());
+
+    return true;
+}
+
+void Screen::drawOutlineRuns(uint8_t x, uint8_t y, uint8_t size, std::vector<uint8_t> &outline, screen::Color color) {
+
+    // Only pixel windows: hardware lines would need a wait for the drawing engine, whose busy time the controller does not report
+    constexpr int Steps[2][2] = {{1, 0}, {0, 1}};
+
+    std::vector<screen::Color> pixels;
+
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (!outline[row * size + col]) {
+                continue;
+            }
+
+            // Longest horizontal or vertical run of outline pixels starting here
+            int step = 0;
+            int length = 0;
+            for (int s = 0; s < 2; s++) {
+                int n = 0;
+                int c = col;
+                int r = row;
+                while (c < size && r < size && outline[r * size + c]) {
+                    n++;
+                    c += Steps[s][0];
+                    r += Steps[s][1];
+                }
+                if (n > length) {
+                    step = s;
+                    length = n;
+                }
+            }
+
+            for (int i = 0; i < length; i++) {
+                outline[(row + i * Steps[step][1]) * size + col + i * Steps[step][0]] = 0;
+            }
+
+            const uint8_t c1 = static_cast<uint8_t>(x + col);
+            const uint8_t r1 = static_cast<uint8_t>(y + row);
+            const uint8_t c2 = static_cast<uint8_t>(x + col + (length - 1) * Steps[step][0]);
+            const uint8_t r2 = static_cast<uint8_t>(y + row + (length - 1) * Steps[step][1]);
+
+            setColumnRowAddr(c1, r1, c2, r2);
+            applyColumnRowAddr();
+            pixels.assign(length, color);
+            sendMultiPixel(pixels);
+        }
+    }
+}
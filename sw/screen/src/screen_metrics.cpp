@@ -0,0 +1,205 @@
+#include <cstdint>   // uint
+#include <cmath>     // ceil
+#include <algorithm> // max
+
+#include "screen_constants.h"
+#include "screen_metrics.h"
+
+namespace screen::metrics {
+
+    StatSnapshot snapshot(const Stat &stat) {
+
+        StatSnapshot s{};
+        s.calls   = stat.calls.load(std::memory_order_relaxed);
+        s.bytes   = stat.bytes.load(std::memory_order_relaxed);
+        s.totalNs = stat.totalNs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < HistogramBuckets; i++) {
+            s.latency[i] = stat.latency[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    StatSnapshot delta(const StatSnapshot &after, const StatSnapshot &before) {
+
+        // A stat reset in between leaves only what came after it
+        if (after.calls < before.calls) {
+            return after;
+        }
+
+        StatSnapshot s{};
+        s.calls   = after.calls - before.calls;
+        s.bytes   = after.bytes - before.bytes;
+        s.totalNs = after.totalNs - before.totalNs;
+        for (size_t i = 0; i < HistogramBuckets; i++) {
+            s.latency[i] = after.latency[i] - before.latency[i];
+        }
+        return s;
+    }
+
+    static void resetStat(Stat &stat) {
+
+        stat.calls.store(0, std::memory_order_relaxed);
+        stat.bytes.store(0, std::memory_order_relaxed);
+        stat.totalNs.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t> &b : stat.latency) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t StatSnapshot::percentileNs(double q) const {
+
+        uint64_t count = 0;
+        for (uint64_t b : latency) {
+            count += b;
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        // Rank of the requested sample (1-based)
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * count)));
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < HistogramBuckets; i++) {
+            if (latency[i] == 0) {
+                continue;
+            }
+            if (seen + latency[i] >= rank) {
+                if (i == 0) {
+                    return 0;
+                }
+                // Linear interpolation inside [2^(i-1), 2^i)
+                const uint64_t low = 1ull << (i - 1);
+                const double frac = static_cast<double>(rank - seen) / latency[i];
+                return low + static_cast<uint64_t>(frac * low);
+            }
+            seen += latency[i];
+        }
+
+        return 1ull << (HistogramBuckets - 1);
+    }
+
+    Snapshot snapshot(const Counters &counters) {
+
+        Snapshot s{};
+        s.commandBytes = counters.commandBytes.load(std::memory_order_relaxed);
+        s.dataBytes    = counters.dataBytes.load(std::memory_order_relaxed);
+        s.busyNs       = counters.busyNs.load(std::memory_order_relaxed);
+        s.glyphCacheHits   = counters.glyphCacheHits.load(std::memory_order_relaxed);
+        s.glyphCacheMisses = counters.glyphCacheMisses.load(std::memory_order_relaxed);
+        s.interruptWakeups  = counters.interruptWakeups.load(std::memory_order_relaxed);
+        s.interruptTimeouts = counters.interruptTimeouts.load(std::memory_order_relaxed);
+        s.txFifoWrites = counters.txFifoWrites.load(std::memory_order_relaxed);
+        s.txFifoFull   = counters.txFifoFull.load(std::memory_order_relaxed);
+        s.txFifoOverflows = counters.txFifoOverflows.load(std::memory_order_relaxed);
+        s.dmaTransfers = counters.dmaTransfers.load(std::memory_order_relaxed);
+        s.dmaErrors    = counters.dmaErrors.load(std::memory_order_relaxed);
+        s.suppressedCommands     = counters.suppressedCommands.load(std::memory_order_relaxed);
+        s.suppressedCommandBytes = counters.suppressedCommandBytes.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < MethodCount; i++) {
+            s.methods[i] = snapshot(counters.methods[i]);
+        }
+        for (size_t i = 0; i < CommandCount; i++) {
+            s.commands[i] = snapshot(counters.commands[i]);
+        }
+
+        return s;
+    }
+
+    void reset(Counters &counters) {
+
+        counters.commandBytes.store(0, std::memory_order_relaxed);
+        counters.dataBytes.store(0, std::memory_order_relaxed);
+        counters.busyNs.store(0, std::memory_order_relaxed);
+        counters.glyphCacheHits.store(0, std::memory_order_relaxed);
+        counters.glyphCacheMisses.store(0, std::memory_order_relaxed);
+        counters.interruptWakeups.store(0, std::memory_order_relaxed);
+        counters.interruptTimeouts.store(0, std::memory_order_relaxed);
+        counters.txFifoWrites.store(0, std::memory_order_relaxed);
+        counters.txFifoFull.store(0, std::memory_order_relaxed);
+        counters.txFifoOverflows.store(0, std::memory_order_relaxed);
+        counters.dmaTransfers.store(0, std::memory_order_relaxed);
+        counters.dmaErrors.store(0, std::memory_order_relaxed);
+        counters.suppressedCommands.store(0, std::memory_order_relaxed);
+        counters.suppressedCommandBytes.store(0, std::memory_order_relaxed);
+
+        for (Stat &stat : counters.methods) {
+            resetStat(stat);
+        }
+        for (Stat &stat : counters.commands) {
+            resetStat(stat);
+        }
+    }
+
+    const char *methodName(Method method) {
+
+        switch (method) {
+            case Method::SetOnOff:               return "setOnOff";
+            case Method::ClearWindow:            return "clearWindow";
+            case Method::DrawBitmap:             return "drawBitmap";
+            case Method::DrawLine:               return "drawLine";
+            case Method::DrawRectangle:          return "drawRectangle";
+            case Method::DrawCircle:             return "drawCircle";
+            case Method::CopyWindow:             return "copyWindow";
+            case Method::DrawImage:              return "drawImage";
+            case Method::DrawSymbol:             return "drawSymbol";
+            case Method::DrawString:             return "drawString";
+            case Method::DrawGlyphRun:           return "drawGlyphRun";
+            case Method::DrawCanvas:             return "drawCanvas";
+            case Method::SetupScrolling:         return "setupScrolling";
+            case Method::EnableScrolling:        return "enableScrolling";
+            case Method::SetScreenOrientation:   return "setScreenOrientation";
+            case Method::SetFillRectangleEnable: return "setFillRectangleEnable";
+            case Method::SetReverseCopyEnable:   return "setReverseCopyEnable";
+            case Method::ApplyDefaultSettings:   return "applyDefaultSettings";
+            default:                             return "unknown";
+        }
+    }
+
+    const char *commandName(uint8_t opcode) {
+
+        switch (static_cast<screen::Command>(opcode)) {
+            case screen::Command::ColumnAddress:         return "ColumnAddress";
+            case screen::Command::RowAddress:            return "RowAddress";
+            case screen::Command::ContrastA:             return "ContrastA";
+            case screen::Command::ContrastB:             return "ContrastB";
+            case screen::Command::ContrastC:             return "ContrastC";
+            case screen::Command::MasterCurrentControl:  return "MasterCurrentControl";
+            case screen::Command::SecondPrechargeSpeedA: return "SecondPrechargeSpeedA";
+            case screen::Command::SecondPrechargeSpeedB: return "SecondPrechargeSpeedB";
+            case screen::Command::SecondPrechargeSpeedC: return "SecondPrechargeSpeedC";
+            case screen::Command::RemapColorDepth:       return "RemapColorDepth";
+            case screen::Command::DisplayStartLine:      return "DisplayStartLine";
+            case screen::Command::DisplayOffset:         return "DisplayOffset";
+            case screen::Command::NormalDisplay:         return "NormalDisplay";
+            case screen::Command::EntireDisplayOn:       return "EntireDisplayOn";
+            case screen::Command::EntireDisplayOff:      return "EntireDisplayOff";
+            case screen::Command::InverseDisplay:        return "InverseDisplay";
+            case screen::Command::MuxRatio:              return "MuxRatio";
+            case screen::Command::DimMode:               return "DimMode";
+            case screen::Command::MasterConfiguration:   return "MasterConfiguration";
+            case screen::Command::DisplayOnDimMode:      return "DisplayOnDimMode";
+            case screen::Command::DisplayOffSleepMode:   return "DisplayOffSleepMode";
+            case screen::Command::DIsplayOnNormalMode:   return "DisplayOnNormalMode";
+            case screen::Command::PowerSaveMode:         return "PowerSaveMode";
+            case screen::Command::PhasePeriodAdjustment: return "PhasePeriodAdjustment";
+            case screen::Command::DisplayClockDiv:       return "DisplayClockDiv";
+            case screen::Command::GrayScaleTable:        return "GrayScaleTable";
+            case screen::Command::EnableLinearGrayScale: return "EnableLinearGrayScale";
+            case screen::Command::PreChargeLevel:        return "PreChargeLevel";
+            case screen::Command::VCOMH:                 return "VCOMH";
+            case screen::Command::CommandLock:           return "CommandLock";
+            case screen::Command::DrawLine:              return "DrawLine";
+            case screen::Command::DrawRectangle:         return "DrawRectangle";
+            case screen::Command::Copy:                  return "Copy";
+            case screen::Command::DimWindow:             return "DimWindow";
+            case screen::Command::ClearWindow:           return "ClearWindow";
+            case screen::Command::FillEnable:            return "FillEnable";
+            case screen::Command::ContinuousScrolling:   return "ContinuousScrolling";
+            case screen::Command::DeactivateScroll:      return "DeactivateScroll";
+            case screen::Command::ActivateScroll:        return "ActivateScroll";
+            default:                                     return "Unknown";
+        }
+    }
+}
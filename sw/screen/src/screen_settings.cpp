@@ -95,4 +95,10 @@ void Screen::applyRemapColorDepth(screen::ApplyMode mode) {
 uint8_t Screen::getRemapColorDepth() const {
 
     return m_remapColorDepthCfg;
+}
+
+screen::RemapColorDepth::ColorDepth Screen::getColorDepth() const {
+
+    return static_cast<screen::RemapColorDepth::ColorDepth>(
+        (m_remapColorDepthCfg & screen::RemapColorDepth::ColorDepth_Msk) >> screen::RemapColorDepth::ColorDepth_Pos);
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include <iostream>   // cerr, endl
+#include <cstdint>    // uint
+#include <cstring>    // strerror
+#include <cerrno>     // errno
+#include <chrono>     // time
+#include <thread>     // sleep_until
+#include <limits>     // numeric_limits
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, ftruncate
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+
+#include "screen_constants.h"
+#include "screen_registers.h"
+#include "screen_trace.h"
+#include "screen_metrics.h"
+#include "screen.h"
+
+using namespace std::chrono_literals;
+
+static constexpr std::chrono::nanoseconds replaySleepThreshold = 200us;
+
+bool Screen::startTrace(const std::string &path, size_t capacity) {
+
+    if (capacity == 0 || capacity > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+
+    stopTrace();
+
+    const size_t mapSize = sizeof(screen::trace::Header) + capacity * sizeof(screen::trace::Record);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open trace file " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(mapSize)) != 0) {
+        std::cerr << "Failed to size trace file " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "mmap failed for trace file " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    m_traceFd = fd;
+    m_traceMapSize = mapSize;
+    m_trace = static_cast<screen::trace::Header *>(map);
+    m_traceRecords = reinterpret_cast<screen::trace::Record *>(m_trace + 1);
+
+    m_trace->magic      = screen::trace::Magic;
+    m_trace->version    = screen::trace::Version;
+    m_trace->recordSize = sizeof(screen::trace::Record);
+    m_trace->capacity   = static_cast<uint32_t>(capacity);
+    m_trace->head       = 0;
+    m_trace->written    = 0;
+    m_trace->startNs    = screen::metrics::nowNs();
+
+    m_traceLastNs = m_trace->startNs;
+
+    return true;
+}
+
+void Screen::stopTrace() {
+
+    if (m_trace) {
+        msync(m_trace, m_traceMapSize, MS_SYNC);
+        munmap(m_trace, m_traceMapSize);
+        m_trace = nullptr;
+        m_traceRecords = nullptr;
+        m_traceMapSize = 0;
+    }
+
+    if (m_traceFd >= 0) {
+        close(m_traceFd);
+        m_traceFd = -1;
+    }
+}
+
+bool Screen::isTracing() const {
+
+    return m_trace != nullptr;
+}
+
+void Screen::recordTrace(uint8_t byte, screen::DataMode mode) {
+
+    const uint64_t now = screen::metrics::nowNs();
+    const uint64_t delta = now - m_traceLastNs;
+    m_traceLastNs = now;
+
+    screen::trace::Record &rec = m_traceRecords[m_trace->head];
+    rec.deltaNs  = (delta > std::numeric_limits<uint32_t>::max()) ? std::numeric_limits<uint32_t>::max() : static_cast<uint32_t>(delta);
+    rec.byte     = byte;
+    rec.mode     = static_cast<uint8_t>(mode);
+    rec.reserved = 0;
+
+    m_trace->head = (m_trace->head + 1 == m_trace->capacity) ? 0 : m_trace->head + 1;
+    m_trace->written++;
+}
+
+bool Screen::replayTrace(const std::string &path, screen::trace::ReplaySpeed speed, screen::trace::ReplayStats *stats) {
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open trace file " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(screen::trace::Header)) {
+        std::cerr << "Invalid trace file " << path << std::endl;
+        close(fd);
+        return false;
+    }
+
+    const size_t mapSize = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        std::cerr << "mmap failed for trace file " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const screen::trace::Header *header = static_cast<const screen::trace::Header *>(map);
+    const screen::trace::Record *records = reinterpret_cast<const screen::trace::Record *>(header + 1);
+
+    // Check header
+    if (header->magic != screen::trace::Magic || header->version != screen::trace::Version ||
+        header->recordSize != sizeof(screen::trace::Record) || header->capacity == 0 || header->head >= header->capacity ||
+        mapSize < sizeof(screen::trace::Header) + static_cast<size_t>(header->capacity) * sizeof(screen::trace::Record)) {
+        std::cerr << "Invalid trace file " << path << std::endl;
+        munmap(map, mapSize);
+        return false;
+    }
+
+    // Oldest record first: once the ring has wrapped it sits at head
+    const bool wrapped = header->written > header->capacity;
+    const uint32_t count = wrapped ? header->capacity : static_cast<uint32_t>(header->written);
+    const uint32_t first = wrapped ? header->head : 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point due = start;
+    std::chrono::nanoseconds recorded{0};
+
+    for (uint32_t i = 0; i < count; i++) {
+        const screen::trace::Record &rec = records[(first + i) % header->capacity];
+
+        // The delta of the oldest record refers to a byte that is no longer in the ring
+        if (i > 0) {
+            recorded += std::chrono::nanoseconds(rec.deltaNs);
+            if (speed == screen::trace::ReplaySpeed::Original) {
+                due += std::chrono::nanoseconds(rec.deltaNs);
+                // Sleeping is too coarse for byte-to-byte gaps, spin on those
+                if (due - std::chrono::steady_clock::now() > replaySleepThreshold) {
+                    std::this_thread::sleep_until(due);
+                }
+                while (std::chrono::steady_clock::now() < due) {
+                    // Wait
+                }
+            }
+        }
+
+        sendSpiByte(rec.byte, static_cast<screen::DataMode>(rec.mode));
+    }
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    // The replayed bytes left the controller in a state the cache knows nothing about
+    m_commandCache.invalidate();
+
+    munmap(map, mapSize);
+
+    if (stats) {
+        stats->bytes = count;
+        stats->recorded = recorded;
+        stats->elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    }
+
+    return true;
+}
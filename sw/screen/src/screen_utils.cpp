@@ -4,45 +4,68 @@
 
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "pixel_encoding.h"
 #include "screen.h"
 
 void Screen::sendPixel(const screen::Color color) {
 
-    uint32_t data = 0;
-	uint8_t byte[3] = {0};
-    uint8_t colorDepth =
-        (m_remapColorDepthCfg & screen::RemapColorDepth::ColorDepth_Msk)
-        >> screen::RemapColorDepth::ColorDepth_Pos;
+    uint8_t bytes[screen::encoding::MaxBytes] = {0};
 
-    switch (static_cast<screen::RemapColorDepth::ColorDepth>(colorDepth)) {
-        case screen::RemapColorDepth::ColorDepth::Color256: {
-            byte[0] = (uint8_t)((color.r>>2) << 5 | (color.g>>3) << 2 | (color.b>>3));
-			sendData(byte[0]);
+    switch (getColorDepth()) {
+        case screen::RemapColorDepth::ColorDepth::Color256:
+            screen::encoding::Color256::pack(color, bytes);
+            sendMultiData(bytes, screen::encoding::Color256::Bytes);
             break;
-        }
-        case screen::RemapColorDepth::ColorDepth::Color65k: {
- 			data = ((color.r) << 11 | (color.g) << 5 | (color.b));
-			byte[0] = (uint8_t)(data >> 8);
-			byte[1] = (uint8_t)(data & 0x000000FF);
-			sendMultiData(byte, 2);
+        case screen::RemapColorDepth::ColorDepth::Color65k:
+            screen::encoding::Color65k::pack(color, bytes);
+            sendMultiData(bytes, screen::encoding::Color65k::Bytes);
             break;
-        }
-        case screen::RemapColorDepth::ColorDepth::Color65kAlt: {
-			data = ((color.r) << 17 | (color.g) << 8 | (color.b) << 1);
-			byte[0] = (uint8_t)(data >> 16);
-			byte[1] = (uint8_t)((data & 0x0000FF00) >> 8);
-			byte[2] = (uint8_t)(data & 0x000000FF);
-			sendMultiData(byte, 3);
+        case screen::RemapColorDepth::ColorDepth::Color65kAlt:
+            screen::encoding::Color65kAlt::pack(color, bytes);
+            sendMultiData(bytes, screen::encoding::Color65kAlt::Bytes);
             break;
-        }
         default:
             break;
     }
 }
 
+template <typename Encoding>
+void Screen::sendMultiPixelAs(const std::vector<screen::Color> &colors) {
+
+    const size_t length = colors.size() * Encoding::Bytes;
+
+    // Encoded straight into the DMA buffer, the registers only if the transfer cannot start
+    if (useDma(length)) {
+        if (m_dmaBusy) {
+            finishDma();
+        }
+        screen::encoding::packPixels<Encoding>(colors.data(), colors.size(), m_dma->buffer());
+        if (!startDma(length)) {
+            sendMultiData(m_dma->buffer(), length);
+        }
+        return;
+    }
+
+    // Encode the whole bitmap first, then stream it
+    m_pixelBuffer.resize(length);
+    screen::encoding::packPixels<Encoding>(colors.data(), colors.size(), m_pixelBuffer.data());
+    sendMultiData(m_pixelBuffer.data(), m_pixelBuffer.size());
+}
+
 void Screen::sendMultiPixel(const std::vector<screen::Color> &colors) {
 
-    for (const screen::Color &c : colors) {
-        sendPixel(c);
+    // The color depth is resolved once per bitmap
+    switch (getColorDepth()) {
+        case screen::RemapColorDepth::ColorDepth::Color256:
+            sendMultiPixelAs<screen::encoding::Color256>(colors);
+            break;
+        case screen::RemapColorDepth::ColorDepth::Color65k:
+            sendMultiPixelAs<screen::encoding::Color65k>(colors);
+            break;
+        case screen::RemapColorDepth::ColorDepth::Color65kAlt:
+            sendMultiPixelAs<screen::encoding::Color65kAlt>(colors);
+            break;
+        default:
+            break;
     }
-}
\ No newline at end of file
+}
@@ -13,19 +13,21 @@
 #include <netinet/in.h> // sockaddr_in
 #include <cstring>      // snprintf
 #include <string_view>  // string_view
-#include <cmath>        // sin, cos
+#include <span>         // span
+#include <algorithm>    // min, max, find_if
 
 #include <nlohmann/json.hpp>
 
 #include "paths.h"
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "analog_clock.h"
+#include "canvas.h"
+#include "compositor.h"
 #include "screen.h"
 #include "service.h"
 #include "test.h"
 
-#define PI 3.14159265
-
 using json = nlohmann::json;
 
 using namespace std::chrono_literals;
@@ -56,6 +58,8 @@ Service::Service(const std::string &configFile) {
     }
 
     applyConfig(configFile);
+
+    buildAnalogClockFace();
 }
 
 Service::~Service() {
@@ -66,9 +70,11 @@ void Service::run() {
 
     using clock = std::chrono::steady_clock;
 
-    constexpr auto period = 100ms;
+    const auto period = m_tickPeriod;
     auto next_tick = clock::now();
 
+    resetMetricsWindow();
+
     while (m_running) {
         next_tick += period;
 
@@ -77,17 +83,34 @@ void Service::run() {
 
         for (service::ScreenContext &ctx : m_screens) {
             if (ctx.powerState) {
+                const uint64_t bytes = ctx.screen->getBytesSent();
+                const uint64_t start = screen::metrics::nowNs();
+
                 updateMode(ctx);
+
+                // Only count updates that actually reached the screen
+                const uint64_t sent = ctx.screen->getBytesSent() - bytes;
+                if (sent > 0) {
+                    ctx.stats->framesRendered++;
+                    screen::metrics::record(ctx.stats->render, screen::metrics::nowNs() - start, sent);
+                }
             }
         }
 
+        updateMetrics();
+
         auto now = clock::now();
 
         if (now < next_tick) {
             std::this_thread::sleep_until(next_tick);
-        } else if (now - next_tick > period) {
-            next_tick = now;
+        } else {
+            m_lateTicks++;
+            if (now - next_tick > period) {
+                next_tick = now;
+            }
         }
+
+        m_wakeups++;
     }
 }
 
@@ -98,6 +121,11 @@ void Service::stop() {
     }
 }
 
+void Service::requestMetricsDump() {
+
+    m_metricsDumpRequested.store(true, std::memory_order_relaxed);
+}
+
 bool Service::setPowerState(service::ScreenContext &ctx, bool value) {
 
     Screen &screen = *ctx.screen;
@@ -118,6 +146,7 @@ void Service::updateMode(service::ScreenContext &ctx) {
     if (ctx.enteringNewMode) {
         Screen &screen = *ctx.screen;
         screen.clearScreen();
+        ctx.text.clear();
     }
 
     switch (ctx.mode) {
@@ -184,9 +213,29 @@ void Service::updateAnalogClockMode(service::ScreenContext &ctx) {
     if (force) {
         renderAnalogClockFace(ctx);
     }
-    if (force || m_timeHasChanged) {
-        renderAnalogClockHands(ctx, force);
+
+    if (ctx.subMode != service::ScreenSubMode::HourMinuteSweep) {
+        if (force || m_timeHasChanged) {
+            renderAnalogClockHands(ctx, force);
+        }
+        return;
+    }
+
+    // Sweeping second hand, a frame every 1 / fps seconds. The ticks run on their own schedule, so a frame is due
+    // from half a frame before its deadline, otherwise a tick waking just early would push it a whole tick back
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::nanoseconds frame = std::chrono::nanoseconds(1s) / ctx.sweepFps;
+    if (!force && now + frame / 2 < ctx.nextSweepFrame) {
+        return;
     }
+    ctx.nextSweepFrame = (force || now - ctx.nextSweepFrame > frame) ? now + frame : ctx.nextSweepFrame + frame;
+
+    const uint64_t bytes = ctx.screen->getBytesSent();
+    const uint64_t start = screen::metrics::nowNs();
+
+    renderAnalogClockHands(ctx, force);
+
+    screen::metrics::record(ctx.stats->sweep, screen::metrics::nowNs() - start, ctx.screen->getBytesSent() - bytes);
 }
 
 json Service::loadJson(const std::string &path) const {
@@ -218,6 +267,16 @@ void Service::applyConfig(const std::string &configFile) {
         throw std::runtime_error("Config file missing 'screens' array");
     }
 
+    // Optional metrics export
+    if (j.contains("metrics")) {
+        const json &metrics = j.at("metrics");
+        m_metricsPath = metrics.value("path", "");
+        m_metricsInterval = std::chrono::milliseconds(metrics.value("intervalMs", service::defaultMetricsInterval.count()));
+        if (m_metricsInterval <= 0ms) {
+            throw std::runtime_error("Invalid metrics intervalMs in config");
+        }
+    }
+
     const json &screens = j.at("screens");
 
     for (const json &s : screens) {
@@ -243,43 +302,56 @@ void Service::applyConfig(const std::string &configFile) {
         screen.setScreenOrientation(parseOrientation(s.at("orientation").get<std::string>()));
         screen.setFillRectangleEnable(s.at("fillRectangle").get<bool>());
         screen.setReverseCopyEnable(s.at("reverseCopy").get<bool>());
-    }
-}
+        screen.setWaitPolicy(parseWaitPolicy(s.value("waitPolicy", "Adaptive")));
 
-service::Line Service::calcHourLine(const service::Time &t) {
+        // Optional SCK divider, the IP default when missing
+        const int divider = s.value("spiClockDivider", 0);
+        if (divider != 0 && !screen.setSpiClockDivider(static_cast<uint32_t>(divider))) {
+            throw std::runtime_error("Invalid spiClockDivider for screen " + id + ", expected " + std::to_string(screen::spi::MinClockDivider) +
+                                     " to " + std::to_string(screen::spi::MaxClockDivider) + " on an IP with SPI_CLK_DIV");
+        }
 
-    service::Line hourLine{};
+        // Optional AXI DMA for whole bitmaps, the UIO device of the DMA in front of the stream port of the IP
+        const std::string dma = s.value("dma", "");
+        if (!dma.empty()) {
+            screen.attachDma(dma);
+            if (!screen.hasDma()) {
+                throw std::runtime_error("DMA of screen " + id + " needs an IP with the stream port");
+            }
+        }
 
-    uint8_t hour12 = (t.hour >= 12) ? (t.hour - 12) : t.hour ;
+        // Optional frame rate of the sweeping second hand
+        const int fps = s.value("fps", static_cast<int>(service::defaultSweepFps));
+        if (fps < service::MinSweepFps || fps > service::MaxSweepFps) {
+            throw std::runtime_error("Invalid fps for screen " + id + ", expected " + std::to_string(service::MinSweepFps) +
+                                     " to " + std::to_string(service::MaxSweepFps));
+        }
+        ctx.sweepFps = static_cast<uint8_t>(fps);
 
-    bool hourUpperHalf = (hour12 <= 3 || hour12 > 9) ? true : false;
-    bool hourRightHalf = (hour12 > 0 && hour12 <= 6) ? true : false;
+        // Optional SPI trace capture
+        const std::string tracePath = s.value("trace", "");
+        if (!tracePath.empty() && !screen.startTrace(tracePath)) {
+            throw std::runtime_error("Failed to start SPI trace for screen " + id + ": " + tracePath);
+        }
+    }
 
-    float hourAngle = ((hour12 / 12.0) * 2 * PI) + ((t.minute / 60.0) * (2 * PI / 12.0));
+    // The loop runs as often as the fastest sweeping clock needs
+    m_tickPeriod = service::defaultTickPeriod;
+    for (const service::ScreenContext &ctx : m_screens) {
+        if (ctx.mode == service::ScreenMode::AnalogClock && ctx.subMode == service::ScreenSubMode::HourMinuteSweep) {
+            m_tickPeriod = std::min<std::chrono::nanoseconds>(m_tickPeriod, std::chrono::nanoseconds(1s) / ctx.sweepFps);
+        }
+    }
+}
 
-    hourLine.x1 = (screen::Geometry::Columns / 2) + static_cast<uint8_t>(hourRightHalf);
-    hourLine.y1 = (screen::Geometry::Rows / 2) - static_cast<uint8_t>(hourUpperHalf);
-    hourLine.x2 = hourLine.x1 + (service::AnalogClockHourHandLength * sin(hourAngle));
-    hourLine.y2 = hourLine.y1 - (service::AnalogClockHourHandLength * cos(hourAngle));
+service::Line Service::calcHourLine(const service::Time &t) {
 
-    return hourLine;
+    return service::analog::HourHands[(t.hour % 12) * 60 + t.minute];
 }
 
 service::Line Service::calcMinuteLine(const service::Time &t) {
 
-    service::Line minuteLine{};
-
-    bool minuteUpperHalf = (t.minute <= 15 || t.minute > 45) ? true : false;
-    bool minuteRightHalf = (t.minute > 0 && t.minute <= 30) ? true : false;
-
-    float minuteAngle = (t.minute / 60.0) * 2 * PI;
-
-    minuteLine.x1 = (screen::Geometry::Columns / 2) + static_cast<uint8_t>(minuteRightHalf);
-    minuteLine.y1 = (screen::Geometry::Rows / 2) - static_cast<uint8_t>(minuteUpperHalf);
-    minuteLine.x2 = minuteLine.x1 + (service::AnalogClockMinuteHandLength * sin(minuteAngle));
-    minuteLine.y2 = minuteLine.y1 - (service::AnalogClockMinuteHandLength * cos(minuteAngle));
-
-    return minuteLine;
+    return service::analog::MinuteHands[t.minute];
 }
 
 std::vector<screen::Color> Service::importDigitAsBitmap(const uint8_t num, screen::Color color) {
@@ -319,6 +391,7 @@ service::ScreenSubMode Service::parseScreenSubMode(const std::string &s) {
     if (s == "HourMinuteSecond")    return service::ScreenSubMode::HourMinuteSecond;
     if (s == "HourMinuteTick")      return service::ScreenSubMode::HourMinuteTick;
     if (s == "HourMinuteColonTick") return service::ScreenSubMode::HourMinuteColonTick;
+    if (s == "HourMinuteSweep")     return service::ScreenSubMode::HourMinuteSweep;
 
     throw std::runtime_error("Invalid Screen SubMode value: " + s);
 }
@@ -333,31 +406,60 @@ screen::Orientation Service::parseOrientation(const std::string &s) {
     throw std::runtime_error("Invalid Orientation value: " + s);
 }
 
-bool Service::renderTextBlock(Screen &s, const service::TextBlock &block, std::string_view text){
+screen::wait::Policy Service::parseWaitPolicy(const std::string &s) {
 
-    uint8_t charWidth  = block.font.width;
-    // uint8_t charHeight = block.font.charHeight;
+    if (s == "Spin")     return screen::wait::Policy::Spin;
+    if (s == "Yield")    return screen::wait::Policy::Yield;
+    if (s == "Hybrid")   return screen::wait::Policy::Hybrid;
+    if (s == "Adaptive") return screen::wait::Policy::Adaptive;
 
-    // Maximum chars that fit horizontally
-    size_t maxChars = block.width / charWidth;
+    throw std::runtime_error("Invalid WaitPolicy value: " + s);
+}
 
-    // Not render text if too long
-    if (text.size() > maxChars) {
-        return false;
+bool Service::renderTextBlock(service::ScreenContext &ctx, const service::TextBlock &block, std::string_view text){
+
+    Screen &s = *ctx.screen;
+    const BitmapFont &font = BitmapFont::builtin(block.font);
+    service::TextBlockState &state = ctx.text[&block];
+
+    // Same text as the last time, nothing to lay out nor to draw
+    if (!state.layout.update(text, font, {block.x, block.y, block.width, block.height}, block.style)) {
+        ctx.stats->layoutHits++;
+        return !state.layout.layout().truncated;
     }
+    ctx.stats->layoutMisses++;
 
-    s.clearWindow(block.x, block.y, block.x + block.width - 1, block.y + block.height - 1);
-    std::this_thread::sleep_for(1ms);
+    const std::vector<screen::text::Line> &lines = state.layout.layout().lines;
+    const screen::text::Line empty{};
+    bool drawn = false;
+
+    for (size_t i = 0; i < std::max(lines.size(), state.shown.size()); i++) {
+        const screen::text::Line &line = (i < lines.size()) ? lines[i] : empty;
+        const uint8_t y = state.layout.lineY(i);
+
+        // A line never shown is drawn over the whole block width
+        if (i >= state.shown.size()) {
+            s.drawGlyphRun(line.glyphs, block.x, y, block.width, line.offset, font, block.color, block.background);
+            drawn = true;
+            continue;
+        }
 
-    // Nothing to draw, just cleared the screen
-    if (text.empty()) {
-        return true;
+        // Otherwise only the glyph cells that changed are sent again
+        for (const screen::text::Columns &columns : screen::text::changedColumns(font, state.shown[i], line, block.width)) {
+            s.drawGlyphRun(line.glyphs, block.x, y, block.width, line.offset, font, block.color, block.background, columns.begin, columns.end);
+            ctx.stats->textCellWindows++;
+            drawn = true;
+        }
     }
 
-    s.drawString(text, block.x, block.y, block.font, block.color);
-    std::this_thread::sleep_for(1ms);
+    // One settle delay per block, not per window
+    if (drawn) {
+        std::this_thread::sleep_for(1ms);
+    }
 
-    return true;
+    state.shown = lines;
+
+    return !state.layout.layout().truncated;
 }
 
 bool Service::renderBitmapBlock(Screen &s, const service::BitmapBlock &block, std::vector<screen::Color> &bitmap){
@@ -378,8 +480,6 @@ bool Service::renderBitmapBlock(Screen &s, const service::BitmapBlock &block, st
 
 void Service::renderDateString(service::ScreenContext &ctx) {
 
-    Screen &s = *ctx.screen;
-
     // Format month
     static const char* months[] = {
         "Jan","Feb","Mar","Apr","May","Jun",
@@ -393,24 +493,22 @@ void Service::renderDateString(service::ScreenContext &ctx) {
                 months[m_date.month - 1],
                 m_date.day);
 
-    renderTextBlock(s, service::InfoDateBlock, dateBuf);
+    renderTextBlock(ctx, service::InfoDateBlock, dateBuf);
 }
 
 void Service::renderTimeString(service::ScreenContext &ctx, const bool forceFullRender) {
 
-    Screen &s = *ctx.screen;
-
     // Hours
     if (forceFullRender || m_time.hour != m_prevTime.hour) {
         std::array<char, 3> hoursBuf{};
         hoursBuf[0] = '0' + m_time.hour / 10;
         hoursBuf[1] = '0' + m_time.hour % 10;
         hoursBuf[2] = '\0';
-        renderTextBlock(s, service::InfoHoursBlock, std::string_view(hoursBuf.data(), 2));
+        renderTextBlock(ctx, service::InfoHoursBlock, std::string_view(hoursBuf.data(), 2));
     }
     // First colon
     if (forceFullRender && ctx.subMode != service::ScreenSubMode::HourMinuteColonTick) {
-        renderTextBlock(s, service::InfoFirstColonBlock, ":");
+        renderTextBlock(ctx, service::InfoFirstColonBlock, ":");
     }
     // Minutes
     if (forceFullRender || m_time.minute != m_prevTime.minute) {
@@ -418,7 +516,7 @@ void Service::renderTimeString(service::ScreenContext &ctx, const bool forceFull
         minutesBuf[0] = '0' + m_time.minute / 10;
         minutesBuf[1] = '0' + m_time.minute % 10;
         minutesBuf[2] = '\0';
-        renderTextBlock(s, service::InfoMinutesBlock, std::string_view(minutesBuf.data(), 2));
+        renderTextBlock(ctx, service::InfoMinutesBlock, std::string_view(minutesBuf.data(), 2));
     }
     // Seconds or tick
     switch(ctx.subMode) {
@@ -427,7 +525,7 @@ void Service::renderTimeString(service::ScreenContext &ctx, const bool forceFull
         case service::ScreenSubMode::HourMinuteSecond:
             // Second colon
             if (forceFullRender) {
-                renderTextBlock(s, service::InfoSecondColonBlock, ":");
+                renderTextBlock(ctx, service::InfoSecondColonBlock, ":");
             }
             // Seconds
             if (forceFullRender || m_time.second != m_prevTime.second) {
@@ -435,21 +533,21 @@ void Service::renderTimeString(service::ScreenContext &ctx, const bool forceFull
                 secondsBuf[0] = '0' + m_time.second / 10;
                 secondsBuf[1] = '0' + m_time.second % 10;
                 secondsBuf[2] = '\0';
-                renderTextBlock(s, service::InfoSecondsBlock, std::string_view(secondsBuf.data(), 2));
+                renderTextBlock(ctx, service::InfoSecondsBlock, std::string_view(secondsBuf.data(), 2));
             }
             break;
         case service::ScreenSubMode::HourMinuteTick:
             // Seconds tick
             if (forceFullRender || m_time.second != m_prevTime.second) {
                 std::string_view tickBuf = (m_time.second % 2) ? "." : " ";
-                renderTextBlock(s, service::InfoTickBlock, tickBuf);
+                renderTextBlock(ctx, service::InfoTickBlock, tickBuf);
             }
             break;
         case service::ScreenSubMode::HourMinuteColonTick:
             // Colon tick
             if (forceFullRender || m_time.second != m_prevTime.second) {
                 std::string_view tickBuf = (m_time.second % 2) ? ":" : " ";
-                renderTextBlock(s, service::InfoFirstColonBlock, tickBuf);
+                renderTextBlock(ctx, service::InfoFirstColonBlock, tickBuf);
             }
             break;
         default:
@@ -460,8 +558,6 @@ void Service::renderTimeString(service::ScreenContext &ctx, const bool forceFull
 
 void Service::renderIpString(service::ScreenContext &ctx) {
 
-    Screen &s = *ctx.screen;
-
     std::string ipString = "";
     std::string maskString = "";
 
@@ -479,8 +575,8 @@ void Service::renderIpString(service::ScreenContext &ctx) {
         maskString = formatIPv4(m_net.netmask);
     }
 
-    renderTextBlock(s, service::InfoIpBlock, ipString);
-    renderTextBlock(s, service::InfoMaskBlock, maskString);
+    renderTextBlock(ctx, service::InfoIpBlock, ipString);
+    renderTextBlock(ctx, service::InfoMaskBlock, maskString);
 }
 
 void Service::renderDigitalClock(service::ScreenContext &ctx, const bool forceFullRender) {
@@ -520,14 +616,14 @@ void Service::renderDigitalClock(service::ScreenContext &ctx, const bool forceFu
                 secondsBuf[0] = '0' + m_time.second / 10;
                 secondsBuf[1] = '0' + m_time.second % 10;
                 secondsBuf[2] = '\0';
-                renderTextBlock(s, service::DigitalClockSecondsBlock, std::string_view(secondsBuf.data(), 2));
+                renderTextBlock(ctx, service::DigitalClockSecondsBlock, std::string_view(secondsBuf.data(), 2));
             }
             break;
         case service::ScreenSubMode::HourMinuteTick:
             // Seconds tick
             if (forceFullRender || m_time.second != m_prevTime.second) {
                 std::string_view tickBuf = (m_time.second % 2) ? "." : " ";
-                renderTextBlock(s, service::DigitalClockTickBlock, tickBuf);
+                renderTextBlock(ctx, service::DigitalClockTickBlock, tickBuf);
             }
             break;
         case service::ScreenSubMode::HourMinuteColonTick:
@@ -543,67 +639,83 @@ void Service::renderDigitalClock(service::ScreenContext &ctx, const bool forceFu
     }
 }
 
-void Service::renderAnalogClockFace(service::ScreenContext &ctx) {
+void Service::buildAnalogClockFace() {
 
-    Screen &s = *ctx.screen;
-    screen::Color c = screen::StandardColor::White;
+    const int cx = service::AnalogClockCenterX - service::AnalogClockFaceX;
+    const int cy = service::AnalogClockCenterY - service::AnalogClockFaceY;
 
-    uint8_t x_coord = (screen::Geometry::Columns / 2) - (screen::Geometry::Rows / 2);
-    uint8_t y_coord = 0;
-    uint8_t d = screen::Geometry::Rows;
+    m_analogFace.clear(service::AnalogClockBackground);
+    m_analogFace.drawArc(cx, cy, service::AnalogClockRadius, 1, 0.0f, 360.0f, service::AnalogClockColor);
 
-    s.drawCircle(x_coord, y_coord, d, c);
-    std::this_thread::sleep_for(1ms);
+    for (const service::Line &tick : service::analog::Ticks) {
+        m_analogFace.drawLine(tick.x1 - service::AnalogClockFaceX, tick.y1 - service::AnalogClockFaceY,
+                              tick.x2 - service::AnalogClockFaceX, tick.y2 - service::AnalogClockFaceY,
+                              service::AnalogClockColor);
+    }
+}
 
-    for (int quarter = 0; quarter < 4; quarter++) {
-        float baseAngle = 0 + (quarter * (PI / 2));
-        bool upperHalf = (quarter == 0 || quarter == 3) ? true : false;
-        bool rightHalf = (quarter == 0 || quarter == 1) ? true : false;
-        for (int tick = 0; tick < 4; tick++) {
-            float drawAngle = baseAngle + (tick * (PI / 6));
-            uint8_t cx = (screen::Geometry::Columns / 2) + static_cast<uint8_t>(rightHalf);
-            uint8_t cy = (screen::Geometry::Rows / 2) - static_cast<uint8_t>(upperHalf);
-            uint8_t x1 = cx + (25 * sin(drawAngle));
-            uint8_t y1 = cy - (25 * cos(drawAngle));
-            uint8_t x2 = cx + (28 * sin(drawAngle));
-            uint8_t y2 = cy - (28 * cos(drawAngle));
-            s.drawLine(x1, y1, x2, y2, c);
-            std::this_thread::sleep_for(1ms);
-        }
+void Service::renderAnalogClockFace(service::ScreenContext &ctx) {
+
+    if (!ctx.clock) {
+        ctx.clock = std::make_unique<Compositor>(service::AnalogClockFaceSize, service::AnalogClockFaceSize,
+                                                 service::AnalogClockLayers, service::AnalogClockBackground);
     }
+
+    // The screen was cleared, the next flush sends the whole face
+    ctx.clock->layer(service::AnalogClockFaceLayer) = m_analogFace;
+    ctx.clock->clearLayer(service::AnalogClockHandsLayer);
+    ctx.clock->clearLayer(service::AnalogClockSecondLayer);
+    ctx.clock->invalidate();
 }
 
 void Service::renderAnalogClockHands(service::ScreenContext &ctx, const bool forceFullRender) {
 
     Screen &s = *ctx.screen;
-    screen::Color c = screen::StandardColor::White;
+    Compositor &clock = *ctx.clock;
+
+    constexpr int fx = service::AnalogClockFaceX;
+    constexpr int fy = service::AnalogClockFaceY;
 
     // Clock hands
-    if (forceFullRender) {
-        service::Line h = calcHourLine(m_time);
-        service::Line m = calcMinuteLine(m_time);
-        s.drawLine(h.x1, h.y1, h.x2, h.y2, c);
-        std::this_thread::sleep_for(1ms);
-        s.drawLine(m.x1, m.y1, m.x2, m.y2, c);
-        std::this_thread::sleep_for(1ms);
-    } else if (m_time.hour != m_prevTime.hour || m_time.minute != m_prevTime.minute) {
-        service::Line h_prev = calcHourLine(m_prevTime);
-        service::Line m_prev = calcMinuteLine(m_prevTime);
-        s.clearWindow(h_prev.x1, h_prev.y1, h_prev.x2, h_prev.y2);
-        std::this_thread::sleep_for(1ms);
-        s.clearWindow(m_prev.x1, m_prev.y1, m_prev.x2, m_prev.y2);
-        std::this_thread::sleep_for(1ms);
-        service::Line h = calcHourLine(m_time);
-        service::Line m = calcMinuteLine(m_time);
-        s.drawLine(h.x1, h.y1, h.x2, h.y2, c);
-        std::this_thread::sleep_for(1ms);
-        s.drawLine(m.x1, m.y1, m.x2, m.y2, c);
+    if (forceFullRender || (m_timeHasChanged && (m_time.hour != m_prevTime.hour || m_time.minute != m_prevTime.minute))) {
+        const service::Line h = calcHourLine(m_time);
+        const service::Line m = calcMinuteLine(m_time);
+
+        Canvas &hands = clock.layer(service::AnalogClockHandsLayer);
+        clock.clearLayer(service::AnalogClockHandsLayer);
+        hands.drawLine(h.x1 - fx, h.y1 - fy, h.x2 - fx, h.y2 - fy, service::AnalogClockColor);
+        hands.drawLine(m.x1 - fx, m.y1 - fy, m.x2 - fx, m.y2 - fy, service::AnalogClockColor);
+    }
+
+    // Seconds marker
+    if (ctx.subMode == service::ScreenSubMode::HourMinuteSecond && (forceFullRender || m_time.second != m_prevTime.second)) {
+        const service::Line &mark = service::analog::SecondMarks[m_time.second % 60];
+
+        clock.clearLayer(service::AnalogClockSecondLayer);
+        clock.layer(service::AnalogClockSecondLayer).fillCircle(mark.x2 - fx, mark.y2 - fy, 1, service::AnalogClockSecondColor);
+    }
+
+    // Sweeping second hand, moved every frame
+    if (ctx.subMode == service::ScreenSubMode::HourMinuteSweep) {
+        const size_t ms = (m_time.second % 60) * 1000 + m_millisecond;
+        const service::Line &hand = service::analog::SweepHands[ms * service::AnalogClockSweepSteps / 60000];
+
+        clock.clearLayer(service::AnalogClockSecondLayer);
+        clock.layer(service::AnalogClockSecondLayer).drawLine(hand.x1 - fx, hand.y1 - fy, hand.x2 - fx, hand.y2 - fy,
+                                                              service::AnalogClockSecondColor);
+    }
+
+    // Only the pixels that differ from the previous composite are sent
+    const std::span<const screen::canvas::Span> damage = clock.compose();
+    if (!damage.empty()) {
+        s.drawCanvas(clock.composite(), damage, fx, fy);
         std::this_thread::sleep_for(1ms);
     }
 
     // Seconds or tick
     switch(ctx.subMode) {
         case service::ScreenSubMode::HourMinute:
+        case service::ScreenSubMode::HourMinuteSweep:
             break;
         case service::ScreenSubMode::HourMinuteSecond:
             if (forceFullRender || m_time.second != m_prevTime.second) {
@@ -611,13 +723,13 @@ void Service::renderAnalogClockHands(service::ScreenContext &ctx, const bool for
                 secondsBuf[0] = '0' + m_time.second / 10;
                 secondsBuf[1] = '0' + m_time.second % 10;
                 secondsBuf[2] = '\0';
-                renderTextBlock(s, service::AnalogClockSecondsBlock, std::string_view(secondsBuf.data(), 2));
+                renderTextBlock(ctx, service::AnalogClockSecondsBlock, std::string_view(secondsBuf.data(), 2));
             }
             break;
         case service::ScreenSubMode::HourMinuteTick:
             if (forceFullRender || m_time.second != m_prevTime.second) {
                 std::string_view tickBuf = (m_time.second % 2) ? "." : " ";
-                renderTextBlock(s, service::AnalogClockTickBlock, tickBuf);
+                renderTextBlock(ctx, service::AnalogClockTickBlock, tickBuf);
             }
             break;
         default:
@@ -628,9 +740,13 @@ void Service::renderAnalogClockHands(service::ScreenContext &ctx, const bool for
 
 void Service::updateDateAndTime() {
 
-    std::time_t now = std::time(nullptr);
+    const std::chrono::system_clock::time_point clockNow = std::chrono::system_clock::now();
+    std::time_t now = std::chrono::system_clock::to_time_t(clockNow);
     std::tm *tm = std::localtime(&now);
 
+    m_millisecond = static_cast<uint16_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(clockNow.time_since_epoch()).count() % 1000);
+
     service::Date newDate {
         .year  = static_cast<uint16_t>(tm->tm_year + 1900),
         .month = static_cast<uint8_t>(tm->tm_mon + 1),
@@ -0,0 +1,250 @@
+#include <iostream>   // cerr
+#include <fstream>    // ofstream
+#include <sstream>    // ostringstream
+#include <cstdio>     // rename
+#include <chrono>     // time
+#include <vector>     // vector
+
+#include "screen_constants.h"
+#include "screen_metrics.h"
+#include "screen.h"
+#include "service.h"
+
+void Service::updateMetrics() {
+
+    if (m_metricsDumpRequested.exchange(false, std::memory_order_relaxed)) {
+        std::cerr << formatMetrics() << std::flush;
+    }
+
+    if (m_metricsPath.empty()) {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < m_metricsNextExport) {
+        return;
+    }
+
+    exportMetrics(m_metricsPath);
+    resetMetricsWindow();
+}
+
+void Service::resetMetricsWindow() {
+
+    m_metricsWindowStart = std::chrono::steady_clock::now();
+    m_metricsNextExport = m_metricsWindowStart + m_metricsInterval;
+    m_windowWakeups = m_wakeups;
+
+    for (service::ScreenContext &ctx : m_screens) {
+        ctx.stats->windowBusyNs = ctx.screen->getMetrics().busyNs;
+        ctx.stats->windowRender = screen::metrics::snapshot(ctx.stats->render);
+        ctx.stats->windowSweep = screen::metrics::snapshot(ctx.stats->sweep);
+    }
+}
+
+// Quantile in seconds of what was recorded in the export window, NaN like Prometheus when nothing was
+static std::string windowQuantile(const screen::metrics::StatSnapshot &window, double q) {
+
+    if (window.calls == 0) {
+        return "NaN";
+    }
+    std::ostringstream out;
+    out << window.percentileNs(q) / 1e9;
+    return out.str();
+}
+
+std::string Service::formatMetrics() const {
+
+    const double windowSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_metricsWindowStart).count();
+
+    std::vector<screen::metrics::Snapshot> snaps;
+    snaps.reserve(m_screens.size());
+    for (const service::ScreenContext &ctx : m_screens) {
+        snaps.push_back(ctx.screen->getMetrics());
+    }
+
+    std::ostringstream out;
+
+    out << "# HELP screen_frames_rendered_total Service updates that sent bytes to the screen\n";
+    out << "# TYPE screen_frames_rendered_total counter\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        out << "screen_frames_rendered_total{screen=\"" << ctx.id << "\"} " << ctx.stats->framesRendered << "\n";
+    }
+
+    out << "# HELP screen_bytes_sent_total Bytes sent through SPI\n";
+    out << "# TYPE screen_bytes_sent_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        const std::string &id = m_screens[i].id;
+        out << "screen_bytes_sent_total{screen=\"" << id << "\",kind=\"command\"} " << snaps[i].commandBytes << "\n";
+        out << "screen_bytes_sent_total{screen=\"" << id << "\",kind=\"data\"} " << snaps[i].dataBytes << "\n";
+    }
+
+    out << "# HELP screen_spi_busy_ratio Fraction of the export window spent inside Screen drawing calls\n";
+    out << "# TYPE screen_spi_busy_ratio gauge\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        const uint64_t busyNs = snaps[i].busyNs - m_screens[i].stats->windowBusyNs;
+        const double ratio = (windowSec > 0) ? (busyNs / 1e9) / windowSec : 0.0;
+        out << "screen_spi_busy_ratio{screen=\"" << m_screens[i].id << "\"} " << ratio << "\n";
+    }
+
+    // The quantiles cover the export window like the busy ratio, the sum and the count since the start
+    out << "# HELP screen_render_latency_seconds Time to render one service update\n";
+    out << "# TYPE screen_render_latency_seconds summary\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        const screen::metrics::StatSnapshot render = screen::metrics::snapshot(ctx.stats->render);
+        const screen::metrics::StatSnapshot window = screen::metrics::delta(render, ctx.stats->windowRender);
+        out << "screen_render_latency_seconds{screen=\"" << ctx.id << "\",quantile=\"0.5\"} " << windowQuantile(window, 0.5) << "\n";
+        out << "screen_render_latency_seconds{screen=\"" << ctx.id << "\",quantile=\"0.99\"} " << windowQuantile(window, 0.99) << "\n";
+        out << "screen_render_latency_seconds_sum{screen=\"" << ctx.id << "\"} " << render.totalNs / 1e9 << "\n";
+        out << "screen_render_latency_seconds_count{screen=\"" << ctx.id << "\"} " << render.calls << "\n";
+    }
+
+    out << "# HELP screen_sweep_frame_seconds Time to render one frame of the sweeping second hand\n";
+    out << "# TYPE screen_sweep_frame_seconds summary\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        const screen::metrics::StatSnapshot sweep = screen::metrics::snapshot(ctx.stats->sweep);
+        if (sweep.calls == 0) {
+            continue;
+        }
+        const screen::metrics::StatSnapshot window = screen::metrics::delta(sweep, ctx.stats->windowSweep);
+        out << "screen_sweep_frame_seconds{screen=\"" << ctx.id << "\",quantile=\"0.5\"} " << windowQuantile(window, 0.5) << "\n";
+        out << "screen_sweep_frame_seconds{screen=\"" << ctx.id << "\",quantile=\"0.99\"} " << windowQuantile(window, 0.99) << "\n";
+        out << "screen_sweep_frame_seconds_sum{screen=\"" << ctx.id << "\"} " << sweep.totalNs / 1e9 << "\n";
+        out << "screen_sweep_frame_seconds_count{screen=\"" << ctx.id << "\"} " << sweep.calls << "\n";
+    }
+
+    out << "# HELP screen_sweep_bytes_total Bytes sent by the frames of the sweeping second hand\n";
+    out << "# TYPE screen_sweep_bytes_total counter\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        const screen::metrics::StatSnapshot sweep = screen::metrics::snapshot(ctx.stats->sweep);
+        if (sweep.calls == 0) {
+            continue;
+        }
+        out << "screen_sweep_bytes_total{screen=\"" << ctx.id << "\"} " << sweep.bytes << "\n";
+    }
+
+    out << "# HELP screen_text_layout_cache_total Text block updates by whether the text was already laid out\n";
+    out << "# TYPE screen_text_layout_cache_total counter\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        out << "screen_text_layout_cache_total{screen=\"" << ctx.id << "\",result=\"hit\"} " << ctx.stats->layoutHits << "\n";
+        out << "screen_text_layout_cache_total{screen=\"" << ctx.id << "\",result=\"miss\"} " << ctx.stats->layoutMisses << "\n";
+    }
+
+    out << "# HELP screen_text_cell_windows_total Windows of changed glyph cells sent to update text lines\n";
+    out << "# TYPE screen_text_cell_windows_total counter\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        out << "screen_text_cell_windows_total{screen=\"" << ctx.id << "\"} " << ctx.stats->textCellWindows << "\n";
+    }
+
+    out << "# HELP screen_glyph_cache_total Glyphs drawn by whether they were already encoded for the screen\n";
+    out << "# TYPE screen_glyph_cache_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        const std::string &id = m_screens[i].id;
+        out << "screen_glyph_cache_total{screen=\"" << id << "\",result=\"hit\"} " << snaps[i].glyphCacheHits << "\n";
+        out << "screen_glyph_cache_total{screen=\"" << id << "\",result=\"miss\"} " << snaps[i].glyphCacheMisses << "\n";
+    }
+
+    out << "# HELP screen_spi_byte_seconds SPI byte time measured when the screen was opened\n";
+    out << "# TYPE screen_spi_byte_seconds gauge\n";
+    for (const service::ScreenContext &ctx : m_screens) {
+        out << "screen_spi_byte_seconds{screen=\"" << ctx.id << "\"} " << ctx.screen->getWaitCalibration().byteTime.count() / 1e9 << "\n";
+    }
+
+    out << "# HELP screen_interrupt_waits_total Sleeps on the UIO interrupt by how they ended\n";
+    out << "# TYPE screen_interrupt_waits_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        const std::string &id = m_screens[i].id;
+        out << "screen_interrupt_waits_total{screen=\"" << id << "\",result=\"interrupt\"} " << snaps[i].interruptWakeups << "\n";
+        out << "screen_interrupt_waits_total{screen=\"" << id << "\",result=\"timeout\"} " << snaps[i].interruptTimeouts << "\n";
+    }
+
+    out << "# HELP screen_tx_fifo_writes_total Burst writes posted to the TX queue of the IP\n";
+    out << "# TYPE screen_tx_fifo_writes_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_tx_fifo_writes_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].txFifoWrites << "\n";
+    }
+
+    out << "# HELP screen_tx_fifo_full_total Times the TX queue of the IP was full and the driver waited for space\n";
+    out << "# TYPE screen_tx_fifo_full_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_tx_fifo_full_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].txFifoFull << "\n";
+    }
+
+    out << "# HELP screen_tx_fifo_overflows_total Times the IP reported SPI_CTRL or SPI_BURST writes dropped by the full TX queue\n";
+    out << "# TYPE screen_tx_fifo_overflows_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_tx_fifo_overflows_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].txFifoOverflows << "\n";
+    }
+
+    out << "# HELP screen_dma_transfers_total Bitmaps sent by the AXI DMA through the stream port of the IP\n";
+    out << "# TYPE screen_dma_transfers_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_dma_transfers_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].dmaTransfers << "\n";
+    }
+
+    out << "# HELP screen_dma_errors_total DMA transfers that failed to start, sent through the registers, or to finish\n";
+    out << "# TYPE screen_dma_errors_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_dma_errors_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].dmaErrors << "\n";
+    }
+
+    out << "# HELP screen_suppressed_commands_total Configuration commands not sent because the controller already held their values\n";
+    out << "# TYPE screen_suppressed_commands_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_suppressed_commands_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].suppressedCommands << "\n";
+    }
+
+    out << "# HELP screen_suppressed_command_bytes_total Command bytes, opcode included, of the suppressed commands\n";
+    out << "# TYPE screen_suppressed_command_bytes_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        out << "screen_suppressed_command_bytes_total{screen=\"" << m_screens[i].id << "\"} " << snaps[i].suppressedCommandBytes << "\n";
+    }
+
+    out << "# HELP screen_method_calls_total Calls to each public Screen method\n";
+    out << "# TYPE screen_method_calls_total counter\n";
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        for (size_t m = 0; m < screen::metrics::MethodCount; m++) {
+            if (snaps[i].methods[m].calls == 0) {
+                continue;
+            }
+            const char *name = screen::metrics::methodName(static_cast<screen::metrics::Method>(m));
+            out << "screen_method_calls_total{screen=\"" << m_screens[i].id << "\",method=\"" << name << "\"} " << snaps[i].methods[m].calls << "\n";
+        }
+    }
+
+    out << "# HELP service_tick_period_seconds Service loop period\n";
+    out << "# TYPE service_tick_period_seconds gauge\n";
+    out << "service_tick_period_seconds " << std::chrono::duration<double>(m_tickPeriod).count() << "\n";
+
+    out << "# HELP service_late_ticks_total Service loop iterations that did not finish within their period\n";
+    out << "# TYPE service_late_ticks_total counter\n";
+    out << "service_late_ticks_total " << m_lateTicks << "\n";
+
+    out << "# HELP service_wakeups_per_second Service loop iterations per second\n";
+    out << "# TYPE service_wakeups_per_second gauge\n";
+    out << "service_wakeups_per_second " << ((windowSec > 0) ? (m_wakeups - m_windowWakeups) / windowSec : 0.0) << "\n";
+
+    return out.str();
+}
+
+bool Service::exportMetrics(const std::string &path) const {
+
+    // Write to a temporary file and rename it, so readers never see a partial file
+    const std::string tmpPath = path + ".tmp";
+
+    std::ofstream file(tmpPath, std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to open metrics file: " << tmpPath << std::endl;
+        return false;
+    }
+
+    file << formatMetrics();
+    file.close();
+
+    if (!file || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write metrics file: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
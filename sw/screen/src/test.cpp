@@ -4,10 +4,16 @@
 #include <chrono>     // time
 #include <random>     // rand
 #include <functional> // reference_wrapper
+#include <filesystem> // directory_iterator
+#include <span>       // span
 
 #include "paths.h"
 #include "screen_constants.h"
 #include "screen_registers.h"
+#include "utf8.h"
+#include "text_layout.h"
+#include "canvas.h"
+#include "compositor.h"
 #include "screen.h"
 #include "test.h"
 
@@ -26,6 +32,10 @@ void Test::full() {
     onOff();
     display();
     randomPattern();
+    spiClock();
+    dma();
+    interrupt();
+    commandCache();
     colorDepth();
     addressIncrement();
     bitmap();
@@ -33,11 +43,16 @@ void Test::full() {
     line();
     rectangle();
     circle();
+    canvas();
+    compositor();
     clear();
     copy();
     image();
     symbol();
     string();
+    bitmapFont();
+    textLayout();
+    utf8();
     standardColors();
     inverseDisplay();
     remap();
@@ -86,6 +101,109 @@ void Test::randomPattern() {
     broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
 }
 
+void Test::spiClock() {
+
+    std::vector<screen::Color> colors(screen::Geometry::Pixels);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<uint8_t> dist31(0, 31);
+    std::uniform_int_distribution<uint8_t> dist63(0, 63);
+
+    for (screen::Color &c : colors) {
+        c = {dist31(gen), dist63(gen), dist31(gen)};
+    }
+
+    // Same pattern with a faster SCK each time, down to the fastest one within the SSD1331 spec
+    for (uint32_t divider = 4 * screen::spi::SpecClockDivider; divider >= screen::spi::SpecClockDivider; divider /= 2) {
+        broadcast([divider](Screen &s){s.setSpiClockDivider(divider);});
+        broadcast([&colors](Screen &s){s.sendMultiPixel(colors);}, 1s);
+    }
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+
+    broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
+}
+
+void Test::dma() {
+
+    const std::vector<screen::Color> bands = {
+        screen::StandardColor::Red,
+        screen::StandardColor::Yellow,
+        screen::StandardColor::Green,
+        screen::StandardColor::Cyan,
+        screen::StandardColor::Blue,
+        screen::StandardColor::Violet
+    };
+    std::vector<screen::Color> colors(screen::Geometry::Pixels);
+
+    // Diagonal bands, easy to tell apart from a shifted or truncated frame
+    for (size_t i = 0; i < colors.size(); i++) {
+        const size_t band = (i % screen::Geometry::Columns + i / screen::Geometry::Columns) / 8;
+        colors[i] = bands[band % bands.size()];
+    }
+
+    // Through the DMA where there is one, then through the registers, the panel must not change
+    for (const std::reference_wrapper<Screen> &s : m_screens) {
+        std::cout << "DMA: " << (s.get().hasDma() ? "attached" : "none, registers only") << std::endl;
+    }
+    broadcast([&colors](Screen &s){s.setDmaEnable(true); s.sendMultiPixel(colors);}, 1s);
+    broadcast([&colors](Screen &s){s.setDmaEnable(false); s.sendMultiPixel(colors);}, 1s);
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+
+    broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
+}
+
+void Test::interrupt() {
+
+    const std::vector<screen::Color> colors(screen::Geometry::Pixels, screen::StandardColor::Blue);
+    std::vector<uint64_t> wakeups;
+    for (const std::reference_wrapper<Screen> &s : m_screens) {
+        std::cout << "Interrupt: " << (s.get().hasInterrupt() ? "UIO" : "none, polling")
+                  << (s.get().hasInterruptSources() ? ", raised by the IP" : "") << std::endl;
+        wakeups.push_back(s.get().getMetrics().interruptWakeups);
+    }
+
+    // Power cycle and full frames, the waits of an IP with the sources end on its interrupt
+    broadcast([](Screen &s){s.setOnOff(false);}, 1s);
+    broadcast([](Screen &s){s.setOnOff(true);}, 1s);
+    broadcast([&colors](Screen &s){s.drawBitmap(0, 0, screen::Geometry::Columns - 1, screen::Geometry::Rows - 1, colors);}, 500ms);
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        std::cout << "Interrupt wake-ups: " << m_screens[i].get().getMetrics().interruptWakeups - wakeups[i] << std::endl;
+    }
+
+    broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
+}
+
+void Test::commandCache() {
+
+    const std::vector<screen::Color> red(16 * 16, screen::StandardColor::Red);
+    const std::vector<screen::Color> green(16 * 16, screen::StandardColor::Green);
+    const std::vector<screen::Color> half(8 * 16, screen::StandardColor::Blue);
+    std::vector<uint64_t> suppressed;
+    for (const std::reference_wrapper<Screen> &s : m_screens) {
+        suppressed.push_back(s.get().getMetrics().suppressedCommands);
+    }
+
+    // Same window over and over, only the first square sends its window
+    for (int i = 0; i < 4; i++) {
+        broadcast([&red](Screen &s){s.drawBitmap(40, 24, 55, 39, red);}, 250ms);
+        broadcast([&green](Screen &s){s.drawBitmap(40, 24, 55, 39, green);}, 250ms);
+    }
+
+    // Half a window leaves the RAM pointer in the middle, the next square sends its window again and is whole
+    broadcast([&half](Screen &s){s.sendMultiPixel(half);}, 500ms);
+    broadcast([&red](Screen &s){s.drawBitmap(40, 24, 55, 39, red);}, 1s);
+
+    for (size_t i = 0; i < m_screens.size(); i++) {
+        std::cout << "Suppressed commands: " << m_screens[i].get().getMetrics().suppressedCommands - suppressed[i] << std::endl;
+    }
+
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+    broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
+}
+
 void Test::colorDepth() {
 
     std::vector<screen::Color> colors(screen::Geometry::Pixels);
@@ -424,6 +542,75 @@ void Test::circle() {
     broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
 }
 
+void Test::canvas() {
+
+    Canvas canvas;
+
+    // Dashboard: title bar, gauge, dial and bar chart composed on the CPU and sent at once
+    canvas.fillRoundedRect(0, 0, screen::Geometry::Columns - 1, 11, 4, screen::StandardColor::Blue);
+    canvas.drawArc(20, 34, 16, 4, -135, 135, screen::StandardColor::Grey);
+    canvas.drawArc(20, 34, 16, 4, -135, 45, screen::StandardColor::Green);
+    canvas.drawThickLine(20, 34, 31, 23, 2, screen::StandardColor::White);
+    canvas.fillCircle(20, 34, 3, screen::StandardColor::Red);
+
+    canvas.fillEllipse(60, 34, 12, 8, screen::StandardColor::Cyan);
+    const screen::canvas::Point arrow[] = {{54, 30}, {66, 34}, {54, 38}};
+    canvas.fillPolygon(arrow, screen::StandardColor::Black);
+
+    for (int bar = 0; bar < 4; bar++) {
+        const int x = 78 + bar * 4;
+        canvas.fillRect(x, 60 - bar * 8 - 8, x + 2, 60, screen::StandardColor::Yellow);
+    }
+    canvas.drawLine(0, 62, screen::Geometry::Columns - 1, 62, screen::StandardColor::White);
+
+    broadcast([&](Screen &s){s.drawCanvas(canvas);}, 2s);
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+
+    // Smaller canvas placed in a window
+    Canvas badge(32, 32);
+    badge.fillCircle(15, 15, 15, screen::StandardColor::Pink);
+    badge.drawArc(15, 15, 11, 3, 0, 360, screen::StandardColor::White);
+    broadcast([&](Screen &s){s.drawCanvas(badge, 32, 16);}, 1s);
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+}
+
+void Test::compositor() {
+
+    // Ball bouncing over a grid: background and ball on separate layers, only changed pixels sent
+    Compositor stack(screen::Geometry::Columns, screen::Geometry::Rows, 2);
+
+    Canvas &grid = stack.layer(0);
+    for (int x = 0; x < screen::Geometry::Columns; x += 8) {
+        grid.drawLine(x, 0, x, screen::Geometry::Rows - 1, screen::StandardColor::Teal);
+    }
+    for (int y = 0; y < screen::Geometry::Rows; y += 8) {
+        grid.drawLine(0, y, screen::Geometry::Columns - 1, y, screen::StandardColor::Teal);
+    }
+
+    int x = 10;
+    int y = 10;
+    int dx = 3;
+    int dy = 2;
+    for (int frame = 0; frame < 60; frame++) {
+        stack.clearLayer(1);
+        stack.layer(1).fillCircle(x, y, 5, screen::StandardColor::Orange);
+
+        const std::span<const screen::canvas::Span> damage = stack.compose();
+        broadcast([&](Screen &s){s.drawCanvas(stack.composite(), damage);}, 30ms);
+
+        if (x + dx < 5 || x + dx > screen::Geometry::Columns - 6) {
+            dx = -dx;
+        }
+        if (y + dy < 5 || y + dy > screen::Geometry::Rows - 6) {
+            dy = -dy;
+        }
+        x += dx;
+        y += dy;
+    }
+
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+}
+
 void Test::clear() {
 
     std::vector<screen::Color> bitmap(50*50, screen::StandardColor::White);
@@ -602,6 +789,166 @@ void Test::string() {
     broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
 }
 
+void Test::bitmapFont() {
+
+    std::vector<BitmapFont> fonts;
+    fonts.push_back(BitmapFont::fromFont(screen::Font8x8));
+    fonts.push_back(BitmapFont::fromFont(screen::Font6x8));
+
+    // Every font deployed with the assets
+    std::error_code ec;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(AppPaths::FONTS_DIR, ec)) {
+        BitmapFont font;
+        if (font.load(entry.path().string())) {
+            fonts.push_back(std::move(font));
+        }
+    }
+
+    for (const BitmapFont &font : fonts) {
+        uint8_t y = 0;
+        for (std::string_view phrase : {"Pmod OLEDrgb", "0123456789:", "\u00c1\u00e9\u00ee\u00f5\u00fc \u00f1 \u20ac"}) {
+            if (y + font.height() > screen::Geometry::Rows) {
+                break;
+            }
+            broadcast([&](Screen &s){s.drawString(phrase, 0, y, font, screen::StandardColor::White);});
+            y += font.height();
+        }
+        // Anti-aliased fonts again, blended over a colored band
+        if (font.bitsPerPixel() > 1 && y + font.height() <= screen::Geometry::Rows) {
+            broadcast([&](Screen &s){
+                s.drawRectangle(0, y, screen::Geometry::Columns - 1, y + font.height() - 1, screen::StandardColor::Blue, screen::StandardColor::Blue);
+                s.drawString("Pmod OLEDrgb", 0, y, font, screen::StandardColor::Yellow, screen::StandardColor::Blue);
+            });
+        }
+        std::this_thread::sleep_for(2s);
+        broadcast([](Screen &s){s.clearScreen();}, 200ms);
+    }
+
+    broadcast([](Screen &s){s.applyDefaultSettings();}, 100ms);
+}
+
+void Test::textLayout() {
+
+    const BitmapFont &font = BitmapFont::builtin(screen::Font6x8);
+    const screen::text::Box box{0, 0, 96, 64};
+
+    const std::vector<screen::text::Style> styles = {
+        {screen::text::Align::Left,   screen::text::Overflow::Wrap,     0},
+        {screen::text::Align::Center, screen::text::Overflow::Wrap,     2},
+        {screen::text::Align::Right,  screen::text::Overflow::Wrap,     0},
+        {screen::text::Align::Center, screen::text::Overflow::Ellipsis, 0},
+        {screen::text::Align::Left,   screen::text::Overflow::Clip,     0},
+    };
+
+    const std::string text = "The quick brown fox jumps over the lazy dog. Pmod OLEDrgb 96x64 SSD1331 screen.";
+
+    for (const screen::text::Style &style : styles) {
+        TextLayout layout;
+        layout.update(text, font, box, style);
+        const std::vector<screen::text::Line> &lines = layout.layout().lines;
+        for (size_t i = 0; i < lines.size(); i++) {
+            broadcast([&](Screen &s){s.drawGlyphRun(lines[i].glyphs, box.x, layout.lineY(i), box.width, lines[i].offset, font, screen::StandardColor::White);});
+        }
+        std::this_thread::sleep_for(2s);
+        broadcast([](Screen &s){s.clearScreen();}, 200ms);
+    }
+
+    // Clock counting from 12:55 to 13:05, only the glyph cells that change are sent
+    const screen::text::Box clock{0, 28, 96, 8};
+    const screen::text::Style clockStyle{screen::text::Align::Center, screen::text::Overflow::Clip, 0};
+    TextLayout layout;
+    screen::text::Line shown{};
+
+    for (int minutes = 12 * 60 + 55; minutes <= 13 * 60 + 5; minutes++) {
+        const std::string time = std::to_string(minutes / 60) + ":" + std::to_string(minutes % 60 / 10) + std::to_string(minutes % 10);
+        layout.update(time, font, clock, clockStyle);
+        const screen::text::Line &line = layout.layout().lines.front();
+        for (const screen::text::Columns &columns : screen::text::changedColumns(font, shown, line, clock.width)) {
+            broadcast([&](Screen &s){s.drawGlyphRun(line.glyphs, clock.x, clock.y, clock.width, line.offset, font, screen::StandardColor::White, screen::StandardColor::Black, columns.begin, columns.end);});
+        }
+        shown = line;
+        std::this_thread::sleep_for(500ms);
+    }
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+}
+
+void Test::utf8() {
+
+    std::mt19937 gen(0x5EED);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_int_distribution<size_t> lengthDist(0, 64);
+    std::uniform_int_distribution<uint32_t> codepointDist(0, 0x10FFFF);
+
+    size_t failures = 0;
+    std::vector<uint32_t> bulk;
+
+    auto encode = [](uint32_t c) {
+        std::string out;
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        return out;
+    };
+
+    // Random bytes: every step consumes 1 to 4 bytes inside the buffer and yields a scalar value
+    // that re-encodes to the consumed bytes, and the bulk decoder agrees with the scalar one
+    for (size_t n = 0; n < 100000; n++) {
+        std::vector<char> bytes(lengthDist(gen));
+        for (char &b : bytes) {
+            b = static_cast<char>((n % 2) ? byteDist(gen) : byteDist(gen) | 0x80);
+        }
+        const std::string_view text(bytes.data(), bytes.size());
+
+        std::vector<uint32_t> scalar;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t start = pos;
+            const uint32_t c = screen::utf8::decode(text, pos);
+            const size_t len = pos - start;
+            const bool surrogate = (c >= 0xD800 && c <= 0xDFFF);
+            if (len < 1 || len > 4 || pos > text.size() || c > 0x10FFFF || surrogate ||
+                (c != screen::utf8::Replacement && encode(c) != text.substr(start, len))) {
+                failures++;
+            }
+            scalar.push_back(c);
+        }
+
+        bulk.clear();
+        screen::utf8::decode(text, bulk);
+        failures += (bulk != scalar);
+    }
+
+    // Random valid codepoints round trip
+    for (size_t n = 0; n < 100000; n++) {
+        const uint32_t c = codepointDist(gen);
+        if (c >= 0xD800 && c <= 0xDFFF) {
+            continue;
+        }
+        const std::string text = encode(c);
+        size_t pos = 0;
+        failures += (screen::utf8::decode(text, pos) != c || pos != text.size());
+    }
+
+    const std::string result = failures ? "UTF-8 FAIL " + std::to_string(failures) : "UTF-8 OK";
+    std::cout << result << std::endl;
+
+    broadcast([&](Screen &s){s.drawString(result, 0, 0, screen::Font8x8, failures ? screen::StandardColor::Red : screen::StandardColor::Green);});
+    std::this_thread::sleep_for(2s);
+    broadcast([](Screen &s){s.clearScreen();}, 200ms);
+}
+
 void Test::standardColors() {
 
     std::vector<screen::Color> colors = {
@@ -0,0 +1,284 @@
+#include <cstdint>     // uint
+#include <algorithm>   // max, min, sort, any_of
+#include <string_view> // string_view
+#include <vector>      // vector
+#include <utility>     // move
+
+#include "utf8.h"
+#include "bitmap_font.h"
+#include "text_layout.h"
+
+size_t screen::text::extent(const BitmapFont &font, std::span<const uint32_t> glyphs) {
+
+    size_t pen = 0;
+    size_t end = 0;
+    for (uint32_t index : glyphs) {
+        const BitmapFont::Glyph &glyph = font.glyph(index);
+        end = std::max(end, pen + glyph.width);
+        pen += glyph.advance;
+    }
+    return end;
+}
+
+namespace {
+
+    struct Cell {
+
+        uint8_t begin;
+        uint8_t end;
+        uint32_t glyph;
+    };
+
+    // Pixels of the box each glyph of a line can touch
+    std::vector<Cell> lineCells(const BitmapFont &font, const screen::text::Line &line, uint8_t width) {
+
+        std::vector<Cell> cells;
+        cells.reserve(line.glyphs.size());
+
+        size_t pen = line.offset;
+        for (uint32_t index : line.glyphs) {
+            const BitmapFont::Glyph &glyph = font.glyph(index);
+            const size_t end = std::min<size_t>(width, pen + std::max(glyph.width, glyph.advance));
+            if (pen < end) {
+                cells.push_back({static_cast<uint8_t>(pen), static_cast<uint8_t>(end), index});
+            }
+            pen += glyph.advance;
+        }
+        return cells;
+    }
+
+    // Cells of from that are not at the same place in to
+    void addChangedCells(const std::vector<Cell> &from, const std::vector<Cell> &to, std::vector<screen::text::Columns> &changed) {
+
+        for (const Cell &cell : from) {
+            const bool kept = std::any_of(to.begin(), to.end(), [&](const Cell &other) {
+                return other.begin == cell.begin && other.end == cell.end && other.glyph == cell.glyph;
+            });
+            if (!kept) {
+                changed.push_back({cell.begin, cell.end});
+            }
+        }
+    }
+}
+
+std::vector<screen::text::Columns> screen::text::changedColumns(const BitmapFont &font, const Line &before, const Line &after, uint8_t width) {
+
+    const std::vector<Cell> beforeCells = lineCells(font, before, width);
+    const std::vector<Cell> afterCells = lineCells(font, after, width);
+
+    std::vector<Columns> changed;
+    addChangedCells(beforeCells, afterCells, changed);
+    addChangedCells(afterCells, beforeCells, changed);
+
+    std::sort(changed.begin(), changed.end(), [](const Columns &a, const Columns &b) {
+        return a.begin < b.begin;
+    });
+
+    // Overlapping or touching ranges are sent as one window
+    std::vector<Columns> merged;
+    for (const Columns &columns : changed) {
+        if (!merged.empty() && columns.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, columns.end);
+        } else {
+            merged.push_back(columns);
+        }
+    }
+    return merged;
+}
+
+bool TextLayout::update(std::string_view text, const BitmapFont &font, screen::text::Box box, screen::text::Style style) {
+
+    if (m_valid && m_font == &font && m_box == box && m_style == style && m_text == text) {
+        return false;
+    }
+
+    m_text.assign(text);
+    m_font = &font;
+    m_box = box;
+    m_style = style;
+    m_valid = true;
+
+    build();
+
+    return true;
+}
+
+const screen::text::Layout &TextLayout::layout() const {
+
+    return m_layout;
+}
+
+uint8_t TextLayout::lineY(size_t line) const {
+
+    return static_cast<uint8_t>(m_box.y + line * (m_font->height() + m_style.lineSpacing));
+}
+
+size_t TextLayout::maxLines() const {
+
+    const size_t height = m_font->height();
+
+    if (m_font->empty() || height == 0 || height > m_box.height) {
+        return 0;
+    }
+    if (m_style.overflow != screen::text::Overflow::Wrap) {
+        return 1;
+    }
+    return (m_box.height + m_style.lineSpacing) / (height + m_style.lineSpacing);
+}
+
+void TextLayout::build() {
+
+    const BitmapFont &font = *m_font;
+    const bool wrap = (m_style.overflow == screen::text::Overflow::Wrap);
+    const size_t limit = maxLines();
+
+    m_layout.lines.clear();
+    m_layout.truncated = false;
+
+    m_codepoints.clear();
+    screen::utf8::decode(m_text, m_codepoints);
+
+    if (limit == 0) {
+        m_layout.truncated = !m_codepoints.empty();
+        return;
+    }
+
+    constexpr size_t NoSpace = SIZE_MAX;
+
+    std::vector<std::vector<uint32_t>> lines;
+    std::vector<uint32_t> line;
+    size_t lastSpace = NoSpace;
+    bool wrapped = false;
+    bool truncated = false;
+
+    for (size_t i = 0; i < m_codepoints.size() && !truncated; i++) {
+        const uint32_t codepoint = m_codepoints[i];
+
+        if (codepoint == '\n') {
+            if (!wrap || lines.size() + 1 == limit) {
+                truncated = true;
+                break;
+            }
+            lines.push_back(std::move(line));
+            line.clear();
+            lastSpace = NoSpace;
+            wrapped = false;
+            continue;
+        }
+
+        // Single line modes are cut once the whole line is known
+        if (!wrap) {
+            line.push_back(font.glyphIndex(codepoint));
+            continue;
+        }
+
+        // Spaces at a wrap point are dropped
+        if (codepoint == ' ' && line.empty() && wrapped) {
+            continue;
+        }
+
+        line.push_back(font.glyphIndex(codepoint));
+        if (codepoint == ' ') {
+            lastSpace = line.size() - 1;
+        }
+
+        while (screen::text::extent(font, line) > m_box.width) {
+            std::vector<uint32_t> next;
+            if (lastSpace != NoSpace) {
+                // Break after the last space, the rest of the word moves down
+                next.assign(line.begin() + lastSpace + 1, line.end());
+                line.resize(lastSpace);
+            } else if (line.size() > 1) {
+                // A word longer than the box is broken anywhere
+                next.push_back(line.back());
+                line.pop_back();
+            } else {
+                // A glyph wider than the box can not be shown
+                line.clear();
+                truncated = true;
+                break;
+            }
+
+            if (lines.size() + 1 == limit) {
+                truncated = true;
+                break;
+            }
+            lines.push_back(std::move(line));
+            line = std::move(next);
+            lastSpace = NoSpace;
+            wrapped = true;
+        }
+    }
+
+    lines.push_back(std::move(line));
+
+    // Single line: cut at the box
+    std::vector<uint32_t> &last = lines.back();
+    while (!last.empty() && screen::text::extent(font, last) > m_box.width) {
+        last.pop_back();
+        truncated = true;
+    }
+
+    if (truncated && m_style.overflow != screen::text::Overflow::Clip) {
+        ellipsise(last);
+    }
+
+    m_layout.truncated = truncated;
+    for (std::vector<uint32_t> &glyphs : lines) {
+        addLine(glyphs);
+    }
+}
+
+void TextLayout::addLine(std::vector<uint32_t> &glyphs) {
+
+    // Trailing spaces do not count for alignment
+    const uint32_t space = m_font->glyphIndex(' ');
+    while (!glyphs.empty() && glyphs.back() == space) {
+        glyphs.pop_back();
+    }
+
+    const size_t width = screen::text::extent(*m_font, glyphs);
+    const size_t room = (width < m_box.width) ? m_box.width - width : 0;
+
+    uint8_t offset = 0;
+    switch (m_style.align) {
+        case screen::text::Align::Center:
+            offset = static_cast<uint8_t>(room / 2);
+            break;
+        case screen::text::Align::Right:
+            offset = static_cast<uint8_t>(room);
+            break;
+        default:
+            break;
+    }
+
+    m_layout.lines.push_back({offset, std::move(glyphs)});
+}
+
+void TextLayout::ellipsise(std::vector<uint32_t> &glyphs) const {
+
+    const BitmapFont &font = *m_font;
+
+    std::vector<uint32_t> ellipsis;
+    if (font.find(screen::text::EllipsisCodepoint)) {
+        ellipsis.push_back(font.glyphIndex(screen::text::EllipsisCodepoint));
+    } else if (font.find('.')) {
+        ellipsis.assign(3, font.glyphIndex('.'));
+    }
+
+    const uint32_t space = font.glyphIndex(' ');
+
+    auto fitsWithEllipsis = [&]() {
+        std::vector<uint32_t> candidate = glyphs;
+        candidate.insert(candidate.end(), ellipsis.begin(), ellipsis.end());
+        return screen::text::extent(font, candidate) <= m_box.width;
+    };
+
+    while (!glyphs.empty() && (!fitsWithEllipsis() || glyphs.back() == space)) {
+        glyphs.pop_back();
+    }
+
+    if (fitsWithEllipsis()) {
+        glyphs.insert(glyphs.end(), ellipsis.begin(), ellipsis.end());
+    }
+}
@@ -0,0 +1,30 @@
+#include <cstdint>     // uint
+#include <cstring>     // memcpy
+#include <string_view> // string_view
+#include <vector>      // vector
+
+#include "utf8.h"
+
+void screen::utf8::decode(std::string_view text, std::vector<uint32_t> &out) {
+
+    constexpr uint64_t HighBits = 0x8080808080808080ull;
+
+    out.reserve(out.size() + text.size());
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        // ASCII fast path, 8 bytes without a high bit are 8 codepoints
+        if (pos + sizeof(uint64_t) <= text.size()) {
+            uint64_t word;
+            std::memcpy(&word, text.data() + pos, sizeof(word));
+            if ((word & HighBits) == 0) {
+                for (size_t i = 0; i < sizeof(word); i++) {
+                    out.push_back(static_cast<uint8_t>(text[pos + i]));
+                }
+                pos += sizeof(word);
+                continue;
+            }
+        }
+        out.push_back(decode(text, pos));
+    }
+}